@@ -0,0 +1,61 @@
+#ifndef CACHED_BOUNDARY_RDHR_WALK_H
+#define CACHED_BOUNDARY_RDHR_WALK_H
+
+#include <Eigen/Dense>
+#include <utility>
+
+#include "lmi_line_oracle.h"
+
+/**
+ * Boundary random directions hit-and-run for spectrahedra, equivalent to
+ * volesti's BRDHRWalk but driven by an LmiLineOracle. The oracle is built
+ * once per walk from the spectrahedron's LMI and then follows the walk's
+ * current point, so every step only forms the direction combination and
+ * updates the cached LMI matrix along the line. Each step emits both
+ * boundary points of the chord, like BRDHRWalk.
+ */
+struct CachedBRDHRWalk
+{
+    template
+    <
+        typename Polytope,
+        typename RandomNumberGenerator
+    >
+    struct Walk
+    {
+        typedef typename Polytope::PointType Point;
+        typedef typename Polytope::NT NT;
+        typedef typename LmiLineOracle<NT>::VT VT;
+
+        Walk(Polytope &P, Point &p, RandomNumberGenerator &)
+            : _oracle(P.getLMI().getMatrices())
+        {
+            _oracle.setPoint(p.getCoefficients());
+        }
+
+        template <typename BallPolytope>
+        inline void apply(BallPolytope &P,
+                          Point &p1,
+                          Point &p2,
+                          unsigned int const& walk_length,
+                          RandomNumberGenerator &rng)
+        {
+            for (unsigned int j = 0; j < walk_length; ++j)
+            {
+                Point v = GetDirection<Point>::apply(P.dimension(), rng);
+                std::pair<NT, NT> bpair = _oracle.lineIntersect(v.getCoefficients());
+
+                p1 = Point(VT(_oracle.point() + bpair.first * v.getCoefficients()));
+                p2 = Point(VT(_oracle.point() + bpair.second * v.getCoefficients()));
+
+                NT lambda = rng.sample_urdist() * (bpair.first - bpair.second) + bpair.second;
+                _oracle.move(lambda);
+            }
+        }
+
+    private:
+        LmiLineOracle<NT> _oracle;
+    };
+};
+
+#endif // CACHED_BOUNDARY_RDHR_WALK_H
@@ -0,0 +1,131 @@
+#ifndef COLUMN_BLOCK_MATRIX_H
+#define COLUMN_BLOCK_MATRIX_H
+
+#include <Eigen/Dense>
+#include <fstream>
+#include <string>
+
+/**
+ * Read-only dense matrix stored on disk in column blocks and accessed
+ * through a memory mapping. File layout (native endianness):
+ *   header: char[4] "LPCB", uint32 version, uint64 rows, uint64 cols, uint64 block_cols
+ *   data:   the matrix in column-major order, so every block of block_cols
+ *           consecutive columns is one contiguous rows x block_cols array
+ * Blocks are visited in order by forEachBlock, which asks the kernel to read
+ * the next block ahead while the current one is processed and drops the
+ * pages of finished blocks, so the resident part of the matrix stays at
+ * about two blocks regardless of its size.
+ */
+class ColumnBlockMatrix {
+public:
+    typedef Eigen::Map<const Eigen::MatrixXd> Block;
+
+    /**
+     * Map an existing column block file
+     * @param filename Path to the file
+     * @throws std::runtime_error if the file cannot be opened, mapped or has a bad header
+     */
+    explicit ColumnBlockMatrix(const std::string& filename);
+    ~ColumnBlockMatrix();
+
+    ColumnBlockMatrix(const ColumnBlockMatrix&) = delete;
+    ColumnBlockMatrix& operator=(const ColumnBlockMatrix&) = delete;
+
+    Eigen::Index rows() const { return num_rows; }
+    Eigen::Index cols() const { return num_cols; }
+    Eigen::Index blockCols() const { return block_cols; }
+    Eigen::Index numBlocks() const { return num_blocks; }
+
+    // Index of the first column of block k and its number of columns
+    Eigen::Index blockStart(Eigen::Index k) const { return k * block_cols; }
+    Eigen::Index blockSize(Eigen::Index k) const;
+
+    // View of block k (rows x blockSize(k)) directly on the mapping
+    Block block(Eigen::Index k) const;
+
+    // Start reading block k in the background
+    void prefetch(Eigen::Index k) const;
+
+    // Drop the pages of block k from this process
+    void release(Eigen::Index k) const;
+
+    /**
+     * Call f(first_column, block) for every block in order, reading the next
+     * block ahead and releasing each block once f returns
+     */
+    template <typename F>
+    void forEachBlock(F&& f) const {
+        for (Eigen::Index k = 0; k < num_blocks; k++) {
+            if (k + 1 < num_blocks) {
+                prefetch(k + 1);
+            }
+            f(blockStart(k), block(k));
+            release(k);
+        }
+    }
+
+    // A x, streamed over the blocks
+    Eigen::VectorXd multiply(const Eigen::VectorXd& x) const;
+
+    // A^T y, streamed over the blocks
+    Eigen::VectorXd multiplyTranspose(const Eigen::VectorXd& y) const;
+
+    /**
+     * Write an in-memory matrix as a column block file
+     * @param filename Path to the file
+     * @param A The matrix
+     * @param block_cols Number of columns per block
+     */
+    static void write(const std::string& filename, const Eigen::MatrixXd& A, Eigen::Index block_cols);
+
+private:
+    // Byte range [begin, end) of block k, widened to page boundaries
+    void blockRange(Eigen::Index k, char*& begin, std::size_t& length) const;
+
+    int fd;
+    char* mapping;
+    std::size_t mapping_size;
+    const double* data;
+    Eigen::Index num_rows;
+    Eigen::Index num_cols;
+    Eigen::Index block_cols;
+    Eigen::Index num_blocks;
+};
+
+/**
+ * Sequential writer for column block files, for matrices that are produced
+ * a few columns at a time and never held in memory as a whole
+ */
+class ColumnBlockWriter {
+public:
+    /**
+     * Create the file and write its header
+     * @param filename Path to the file
+     * @param rows Number of rows
+     * @param cols Total number of columns that will be appended
+     * @param block_cols Number of columns per block
+     */
+    ColumnBlockWriter(const std::string& filename, Eigen::Index rows, Eigen::Index cols, Eigen::Index block_cols);
+
+    /**
+     * Append the next columns of the matrix
+     * @param columns rows x k matrix
+     */
+    void append(const Eigen::Ref<const Eigen::MatrixXd>& columns);
+
+    /**
+     * Flush and close the file
+     * @throws std::runtime_error if fewer columns than announced were appended
+     */
+    void close();
+
+    Eigen::Index written() const { return written_cols; }
+
+private:
+    std::ofstream out;
+    Eigen::Index num_rows;
+    Eigen::Index num_cols;
+    Eigen::Index written_cols;
+};
+
+#endif // COLUMN_BLOCK_MATRIX_H
@@ -0,0 +1,95 @@
+#ifndef INCREMENTAL_LP_H
+#define INCREMENTAL_LP_H
+
+#include <Eigen/Dense>
+#include "interior_point_lp.h"
+#include "lp_utils.h"
+
+/**
+ * Persistent linear program min c^T x s.t. Ax = b, x >= 0 for cutting-plane
+ * and column-generation loops. The problem is scaled once; appended rows and
+ * columns are scaled with the existing factors and written into spare
+ * capacity of the stored matrix, which grows geometrically.
+ *
+ * Every solve keeps an iterate for the next one: the first iterate whose
+ * relative duality gap falls below the warm-start level with residuals a
+ * tenth of that, which is nearly feasible but still well inside the
+ * positive orthant. The next solve starts from that point with zero
+ * multipliers for new rows and centered values for new columns; of the
+ * existing components only the blocking pairs (x_i s_i far below mu) are
+ * shifted. A warm start that has not converged after as many iterations as
+ * the last converged cold solve took is abandoned for a cold solve.
+ */
+class IncrementalLP {
+public:
+    /**
+     * Take a copy of the initial problem and scale it according to the
+     * current InteriorPointLP parameters
+     * @param A The constraint matrix
+     * @param b The right-hand side vector
+     * @param c The objective coefficient vector
+     */
+    IncrementalLP(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, const Eigen::VectorXd& c);
+
+    /**
+     * Append constraints a_i^T x = b_i. Their multipliers start at zero.
+     * @param A_rows The new rows (k x n)
+     * @param b_rows The new right-hand side entries (k)
+     */
+    void addRows(const Eigen::MatrixXd& A_rows, const Eigen::VectorXd& b_rows);
+
+    /**
+     * Append variables. They start at the centrality of the stored point,
+     * with a dual slack taken from the current multipliers.
+     * @param A_cols The new columns (m x k)
+     * @param c_cols The new objective coefficients (k)
+     */
+    void addColumns(const Eigen::MatrixXd& A_cols, const Eigen::VectorXd& c_cols);
+
+    /**
+     * Make room for a problem of up to rows x cols without reallocating
+     * @param rows Number of constraints to reserve
+     * @param cols Number of variables to reserve
+     */
+    void reserve(Eigen::Index rows, Eigen::Index cols);
+
+    /**
+     * Solve the current problem, warm started from the previous solve if any
+     * @return The result in terms of the unscaled problem; iterations
+     *         include those of an abandoned warm start
+     */
+    InteriorPointLP::Result solve();
+
+    /**
+     * Set the relative duality gap n mu / (1 + |c^T x|) at which a solve
+     * keeps its iterate as the next warm start (default 1)
+     * @param level The warm-start level
+     */
+    void setWarmStartLevel(double level) { warm_start_level = level; }
+
+    int rows() const { return m; }
+    int cols() const { return n; }
+
+private:
+    // The current constraint matrix (scaled)
+    Eigen::Block<const Eigen::MatrixXd> matrix() const { return A_buffer.topLeftCorner(m, n); }
+
+    // Keep the iterate of a solve as the next warm start
+    void storeWarmStart(const InteriorPointLP::Snapshot& snapshot);
+
+    Eigen::MatrixXd A_buffer;     // Scaled A in the top-left m x n corner, spare capacity around it
+    Eigen::Index m, n;            // Current problem size
+    Eigen::VectorXd b;            // Scaled right-hand side
+    Eigen::VectorXd c;            // Scaled objective
+    double b_norm_sq;             // Squared norm of the unscaled b
+    double c_norm_sq;             // Squared norm of the unscaled c
+    LPUtils::ScalingInfo scaling;
+
+    Eigen::VectorXd x, lambda, s; // Warm-start point (scaled)
+    bool warm;                    // Whether x, lambda and s hold a usable point
+    int cold_iterations;          // Iterations of the last converged cold solve
+    double warm_start_level;      // Relative duality gap of the kept iterate
+    double shift_fraction;        // Pairs below this fraction of mu are shifted (shiftBlockingPairs)
+};
+
+#endif // INCREMENTAL_LP_H
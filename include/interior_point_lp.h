@@ -4,25 +4,65 @@
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
 #include <vector>
+#include <limits>
 #include <stdexcept>
 #include <iostream>
 #include "lp_utils.h"
 
 class InteriorPointLP {
 public:
+    // Why the interior point iteration stopped
+    enum class Status {
+        Optimal,        // Converged to tol
+        GapReached,     // Relative gap between lower_bound and upper_bound below gap_target (anytime mode)
+        TimeLimit,      // time_budget exhausted (anytime mode)
+        IterationLimit, // max_iter iterations without convergence
+        Breakdown       // Non-finite iterate or failed factorization
+    };
+
     // Structure to hold the result of the solve function
     struct Result {
-        bool success;             // Whether the solver succeeded
+        bool success;             // Whether the solver converged to tol (status == Optimal)
+        Status status = Status::IterationLimit; // Why the iteration stopped
         Eigen::VectorXd x;        // Optimal solution
+        Eigen::VectorXd lambda;   // Dual solution (multipliers of Ax = b)
+        Eigen::VectorXd s;        // Dual slacks
         double optimal_value;     // Optimal objective value
         double primal_infeas;     // Primal infeasibility
         double dual_infeas;       // Dual infeasibility
         double gap;               // Complementarity gap
+        int iterations = 0;       // Number of interior point iterations
+        double setup_time = 0.0;  // Seconds spent copying, scaling and computing the initial point
+        double iteration_time = 0.0; // Seconds spent in the iteration loop
+        double lower_bound = -std::numeric_limits<double>::infinity(); // Certified lower bound on the optimal value (anytime mode)
+        double upper_bound = std::numeric_limits<double>::infinity();  // Objective of the best point feasible to 1e-2 tol (anytime mode)
     };
 
-    // Main solver function
+    // Iterate kept from a run for later warm starts: the first iterate whose
+    // relative duality gap n mu / (1 + |c^T x|) is at most gap and whose
+    // relative residuals are at most residual. Points that far from the
+    // boundary restart well after the problem changes; the final iterate of
+    // a converged run does not.
+    struct Snapshot {
+        double gap = 0.0;      // Relative duality gap to keep the iterate at
+        double residual = 0.0; // Relative primal and dual residual to keep the iterate at
+        bool taken = false;    // Whether x, lambda and s hold an iterate
+        Eigen::VectorXd x, lambda, s;
+    };
+
+    // Main solver function. With time_budget or gap_target set (anytime mode)
+    // every iterate is also turned into bounds on the optimal value, reported
+    // in lower_bound and upper_bound. lower_bound is certified (the dual
+    // objective of multipliers with nonnegative reduced costs); upper_bound is
+    // the objective of a point x >= 0 that satisfies A x = b to 1e-2 tol in
+    // the units of the original problem, so it holds to that feasibility
+    // tolerance. In anytime mode the solve returns the point of upper_bound
+    // (and the dual point of lower_bound, if any) whenever one was found,
+    // converged or not, and lower_bound <= optimal_value <= upper_bound. A
+    // solve stopped by the budget or the gap target reports that in status
+    // and has success false.
     static Result solve(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, const Eigen::VectorXd& c);
-    
+
     // Algorithm parameters
     struct Parameters {
         double tol = 1e-6;          // Tolerance for convergence
@@ -32,92 +72,138 @@ public:
         bool use_scaling = true;    // Whether to scale the problem
         bool verbose = false;       // Print detailed progress information
         int debug_level = 0;        // Debug level: 0=none
+        bool split_dense_columns = true; // Factor sparse A with its dense columns split off
+        double dense_column_ratio = 0.1; // Columns with more nonzeros than this fraction of rows are dense
+        double sparse_density = 0.05;   // Use the sparse factorization if the other columns are at most this dense
+        bool use_tiny_kernels = true;   // Use the fixed-size kernels (tiny_lp.h) for very small problems
+        double time_budget = 0.0;       // Wall-clock seconds per solve, 0 for no limit (anytime mode)
+        double gap_target = 0.0;        // Stop once (upper_bound - lower_bound) / max(1, |upper_bound|) is below this, 0 to disable (anytime mode)
     };
     
     // Set algorithm parameters
     static void setParameters(const Parameters& params);
 
+    // Get the current algorithm parameters
+    static const Parameters& getParameters();
+
 private:
+    friend class IncrementalLP;
+    friend class LPSolveCache;
+    friend class OutOfCoreLP;
+
     static Parameters params;
+
+    // Run the interior point iterations (PredictorCorrector) with parameters
+    // p on an already scaled problem, starting from the given point (x > 0,
+    // s > 0). The final iterate is left in x, lambda and s (still scaled);
+    // the result is mapped back through scaling. b_norm and c_norm are the
+    // norms of the unscaled b and c used by the relative convergence
+    // tolerances. elapsed is the time already spent on this solve, which
+    // counts against p.time_budget. A may be a block of a larger matrix.
+    static Result iterate(
+        const Parameters& p,
+        const Eigen::Ref<const Eigen::MatrixXd>& A,
+        const Eigen::VectorXd& b,
+        const Eigen::VectorXd& c,
+        Eigen::VectorXd& x,
+        Eigen::VectorXd& lambda,
+        Eigen::VectorXd& s,
+        const LPUtils::ScalingInfo& scaling,
+        double b_norm,
+        double c_norm,
+        double elapsed = 0.0,
+        Snapshot* snapshot = nullptr);
+
+    // Prepare a stored iterate for a warm start on a modified problem. Only
+    // the blocking pairs, whose product x_i s_i is below fraction * mu, are
+    // shifted: the smaller of x_i and s_i is raised until the product
+    // reaches fraction * mu (both to sqrt(fraction * mu) if both are
+    // smaller). All other components keep their values (Gondzio).
+    static void shiftBlockingPairs(Eigen::VectorXd& x, Eigen::VectorXd& s, double fraction);
+
+    // PredictorCorrector backend for an in-memory A (defined in interior_point_lp.cpp)
+    struct DenseBackend;
+
+    // Structure and factorization of the normal equations matrix A D A^T.
+    // The structure is analyzed once per solve. If A is sparse apart from a
+    // few dense columns, the sparse columns are factored with a sparse LDL^T
+    // and the dense ones are added back as a low-rank Sherman-Morrison-Woodbury
+    // correction; otherwise A D A^T is formed and factored densely.
+    struct NormalEquations {
+        bool use_sparse = false;              // Whether the split factorization is used
+        std::vector<int> sparse_cols;         // Indices of the sparse columns of A
+        std::vector<int> dense_cols;          // Indices of the dense columns of A
+        Eigen::SparseMatrix<double> A_sparse; // Sparse columns of A (not kept by OutOfCoreLP)
+        Eigen::MatrixXd A_dense;              // Dense columns of A
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldlt;           // Factorization of the sparse part
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> augmented_ldlt; // Quasi-definite fallback
+        bool analyzed = false;                // Symbolic analysis of ldlt done
+        bool augmented_analyzed = false;      // Symbolic analysis of augmented_ldlt done
+        Eigen::SparseMatrix<double> M_sparse; // Regularized A_s D_s A_s^T of the last factorization
+        Eigen::VectorXd d_dense;              // Scaling of the dense columns in the last factorization
+        Eigen::MatrixXd U, Y;                 // A_d D_d^(1/2) and M_sparse^-1 U
+        Eigen::LDLT<Eigen::MatrixXd> small_ldlt; // Factorization of I + U^T Y
+        bool use_augmented = false;           // Whether augmented_ldlt holds the last factorization
+        Eigen::LDLT<Eigen::MatrixXd> dense_ldlt; // Factorization of the dense normal matrix
+    };
+
+    // Detect dense columns and decide whether to use the split factorization
+    static void analyzeNormalEquations(const Eigen::Ref<const Eigen::MatrixXd>& A, const Parameters& p,
+                                       NormalEquations& ne);
+
+    // Split columns into sparse and dense ones by their nonzero counts (A has
+    // m rows). Returns whether the split factorization pays off.
+    static bool splitColumns(const std::vector<int>& col_nnz, int m, const Parameters& p, NormalEquations& ne);
+
+    // Factor A D A^T + regularization for the scaling diagonal d
+    static bool factorNormalEquations(
+        const Eigen::Ref<const Eigen::MatrixXd>& A,
+        const Parameters& p,
+        NormalEquations& ne,
+        const Eigen::VectorXd& d);
+
+    // Regularize and factor an already formed dense normal matrix (overwritten)
+    static bool factorDenseNormalEquations(Eigen::MatrixXd& normal, const Parameters& p, NormalEquations& ne);
+
+    // Factor the split form of A D A^T + regularization
+    static bool factorSplitNormalEquations(NormalEquations& ne, const Parameters& p, const Eigen::VectorXd& d);
+
+    // Regularize and factor a split form whose sparse part M_sparse = A_s D_s A_s^T
+    // and dense column scaling d_dense are already formed
+    static bool factorFormedSplitNormalEquations(NormalEquations& ne, const Parameters& p);
+
+    // Factor the quasi-definite augmented system [M_s A_d; A_d^T -D_d^-1]
+    static bool factorAugmentedNormalEquations(NormalEquations& ne);
+
+    // Solve (A D A^T + regularization) dlambda = rhs with the last factorization
+    static bool solveNormalEquations(
+        NormalEquations& ne,
+        const Eigen::VectorXd& rhs,
+        Eigen::VectorXd& dlambda);
     
-    // Calculate initial point
+    // Calculate initial point (PredictorCorrector::initialPoint)
     static void computeInitialPoint(
-        const Eigen::MatrixXd& A, 
         const Eigen::VectorXd& b, 
         const Eigen::VectorXd& c,
         Eigen::VectorXd& x, 
         Eigen::VectorXd& lambda, 
         Eigen::VectorXd& s);
-    
-    // Compute affine scaling direction (predictor step)
-    static void computeAffineDirection(
-        const Eigen::MatrixXd& A,
-        const Eigen::VectorXd& x, 
-        const Eigen::VectorXd& lambda, 
-        const Eigen::VectorXd& s,
-        Eigen::VectorXd& dx_aff, 
-        Eigen::VectorXd& dlambda_aff, 
-        Eigen::VectorXd& ds_aff,
-        const Eigen::VectorXd& rc, 
-        const Eigen::VectorXd& rb);
-    
-    // Compute step lengths
-    static void computeStepLengths(
-        const Eigen::VectorXd& x, 
-        const Eigen::VectorXd& s,
-        const Eigen::VectorXd& dx, 
-        const Eigen::VectorXd& ds,
-        double& alpha_pri, 
-        double& alpha_dual);
-    
-    // Compute centering parameter
-    static double computeCenteringParameter(
-        const Eigen::VectorXd& x, 
-        const Eigen::VectorXd& s,
-        const Eigen::VectorXd& dx_aff, 
-        const Eigen::VectorXd& ds_aff,
-        double alpha_pri_aff, 
-        double alpha_dual_aff,
-        double mu);
-    
-    // Compute combined direction (corrector step)
-    static void computeCombinedDirection(
-        const Eigen::MatrixXd& A,
-        const Eigen::VectorXd& x, 
-        const Eigen::VectorXd& lambda, 
-        const Eigen::VectorXd& s,
-        const Eigen::VectorXd& dx_aff, 
-        const Eigen::VectorXd& ds_aff,
-        Eigen::VectorXd& dx, 
-        Eigen::VectorXd& dlambda, 
-        Eigen::VectorXd& ds,
-        const Eigen::VectorXd& rc, 
-        const Eigen::VectorXd& rb,
-        double sigma, 
-        double mu);
-    
-    // Solve the linear system with improved numerical stability
-    static bool solveLinearSystem(
-        const Eigen::MatrixXd& A,
-        const Eigen::VectorXd& x, 
-        const Eigen::VectorXd& s,
-        const Eigen::VectorXd& rhs1, 
-        const Eigen::VectorXd& rhs2, 
-        const Eigen::VectorXd& rhs3,
-        Eigen::VectorXd& dx, 
-        Eigen::VectorXd& dlambda, 
-        Eigen::VectorXd& ds);
-    
-    // Check convergence criteria
-    static bool checkConvergence(
-        const Eigen::VectorXd& x, 
-        const Eigen::VectorXd& lambda, 
+
+    // Fill objective, residuals and the rescaled solution of a result
+    static void fillResult(
+        Result& result,
+        const Eigen::VectorXd& x,
+        const Eigen::VectorXd& lambda,
         const Eigen::VectorXd& s,
-        const Eigen::VectorXd& rc, 
+        const Eigen::VectorXd& rc,
         const Eigen::VectorXd& rb,
-        double mu,
-        const Eigen::VectorXd& b_orig, 
-        const Eigen::VectorXd& c_orig);
+        const Eigen::VectorXd& c,
+        const LPUtils::ScalingInfo& scaling,
+        double b_norm,
+        double c_norm);
+
+    // Print how a solve ended (verbose mode)
+    static void printSummary(const Result& result, Status status, bool anytime_point);
 };
 
 #endif // INTERIOR_POINT_LP_H
\ No newline at end of file
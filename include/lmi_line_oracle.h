@@ -0,0 +1,363 @@
+#ifndef LMI_LINE_ORACLE_H
+#define LMI_LINE_ORACLE_H
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * Boundary oracle for the spectrahedron {x | A(x) = A0 + sum_i x_i A_i <= 0}
+ * (negative semidefinite, as in volesti's LMI) that is tailored to
+ * hit-and-run walks.
+ *
+ * The lower triangles of A_1..A_d are packed as the columns of one
+ * (m (m + 1) / 2) x d matrix, stored sparse when few entries are nonzero.
+ * Forming B(v) = sum_i v_i A_i is then a single matrix-vector product
+ * (O(nnz) for sparse data) instead of d separate m x m updates. The oracle
+ * keeps A(x) for the current point; moving along the line updates
+ * A(x + t v) = A(x) + t B(v) in O(m^2), and A(x) is rebuilt from scratch
+ * every refresh_interval moves to bound round-off drift.
+ *
+ * The chord comes from the extreme eigenvalues of C = L^-1 B L^-T with
+ * -A(x) = L L^T. For m <= dense_threshold C is formed and solved densely.
+ * For larger m, Lanczos only applies C to vectors (two triangular solves
+ * and one symmetric product, O(m^2) each) and stops once both extreme Ritz
+ * values have converged, so a step costs one Cholesky factorization plus
+ * O(k m^2) for k Lanczos steps rather than O(m^3) for the dense eigensolver.
+ * A Ritz value plus its residual bound is only close to some eigenvalue, not
+ * necessarily to the extreme one, so the widened Lanczos ends are certified
+ * by a Cholesky factorization of -A(x + t v) at both chord ends: if either
+ * fails, an extreme eigenvalue was missed and the dense eigensolver decides.
+ * Either way the returned chord lies inside the spectrahedron.
+ *
+ * If round-off leaves the current point just outside the spectrahedron,
+ * A(x) is rebuilt; if that does not help, the last move is shortened and,
+ * failing that, the point is pulled toward the one given to setPoint until
+ * it is strictly inside again.
+ */
+template <typename NT>
+class LmiLineOracle {
+public:
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, Eigen::Dynamic> MT;
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, 1> VT;
+    typedef Eigen::SparseMatrix<NT> SpMT;
+
+    /**
+     * @param matrices A0, A1, ..., Ad, all symmetric m x m
+     * @param sparse_density The packed A_i are stored sparse if at most this fraction is nonzero
+     * @param refresh_interval Number of moves between full rebuilds of A(x)
+     * @param dense_threshold Largest m for which the dense eigensolver is used
+     */
+    LmiLineOracle(const std::vector<MT>& matrices, double sparse_density = 0.1,
+                  unsigned int refresh_interval_ = 100, Eigen::Index dense_threshold_ = 64)
+        : last_step(0), refresh_interval(refresh_interval_), dense_threshold(dense_threshold_),
+          moves_since_refresh(0), has_safe_point(false)
+    {
+        if (matrices.size() < 2) {
+            throw std::invalid_argument("LMI needs A0 and at least one A_i");
+        }
+        A0 = matrices[0];
+        const Eigen::Index m = A0.rows();
+        const Eigen::Index d = matrices.size() - 1;
+        const Eigen::Index packed_size = m * (m + 1) / 2;
+
+        Eigen::Index nnz = 0;
+        for (Eigen::Index i = 0; i < d; i++) {
+            const MT& Ai = matrices[i + 1];
+            if (Ai.rows() != m || Ai.cols() != m) {
+                throw std::invalid_argument("LMI matrices must all have the same size");
+            }
+            nnz += (Ai.template triangularView<Eigen::Lower>().toDenseMatrix().array() != NT(0)).count();
+        }
+
+        use_sparse = nnz <= sparse_density * double(packed_size) * double(d);
+        if (use_sparse) {
+            std::vector<Eigen::Triplet<NT>> entries;
+            entries.reserve(nnz);
+            for (Eigen::Index i = 0; i < d; i++) {
+                const MT& Ai = matrices[i + 1];
+                Eigen::Index row = 0;
+                for (Eigen::Index col = 0; col < m; col++) {
+                    for (Eigen::Index r = col; r < m; r++, row++) {
+                        if (Ai(r, col) != NT(0)) {
+                            entries.emplace_back(row, i, Ai(r, col));
+                        }
+                    }
+                }
+            }
+            sparse_packed.resize(packed_size, d);
+            sparse_packed.setFromTriplets(entries.begin(), entries.end());
+        } else {
+            dense_packed.resize(packed_size, d);
+            for (Eigen::Index i = 0; i < d; i++) {
+                pack(matrices[i + 1], dense_packed.col(i));
+            }
+        }
+
+        // Fixed pseudo-random Lanczos start vector, so runs are reproducible
+        start = VT(m);
+        unsigned long long state = 0x9e3779b97f4a7c15ULL;
+        for (Eigen::Index i = 0; i < m; i++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            start(i) = NT(0.5) + NT((state >> 11) & 0xfffff) / NT(0x100000);
+        }
+        start.normalize();
+
+        x = VT::Zero(d);
+        v = VT::Zero(d);
+        A = A0;
+        B = MT::Zero(m, m);
+        packed = VT::Zero(packed_size);
+    }
+
+    Eigen::Index dimension() const { return x.size(); }
+    const VT& point() const { return x; }
+
+    // Place the oracle at x_new (an interior point) and rebuild A(x) from scratch
+    void setPoint(const VT& x_new) {
+        x = x_new;
+        anchor = x_new;
+        combine(x, A);
+        A += A0;
+        moves_since_refresh = 0;
+        has_safe_point = false;
+    }
+
+    // Select the line direction and form B(v)
+    void setDirection(const VT& v_new) {
+        v = v_new;
+        combine(v, B);
+    }
+
+    /**
+     * Intersect the current line with the boundary
+     * @return (t_plus, t_minus): the largest t > 0 and smallest t < 0 such that
+     *         x + t v stays in the spectrahedron (+-infinity if unbounded)
+     */
+    std::pair<NT, NT> intersect() {
+        // With -A(x) = L L^T, A(x) + t B = -L (I - t C) L^T for C = L^-1 B L^-T,
+        // so the boundary is at t = 1 / mu for the extreme eigenvalues mu of C.
+        factorize();
+
+        NT mu_min, mu_max;
+        if (A.rows() <= dense_threshold || !lanczosExtremes(mu_min, mu_max)
+            || !strictlyInside(mu_max) || !strictlyInside(mu_min)) {
+            denseExtremes(mu_min, mu_max);
+        }
+
+        const NT inf = std::numeric_limits<NT>::infinity();
+        NT t_plus = mu_max > NT(0) ? NT(1) / mu_max : inf;
+        NT t_minus = mu_min < NT(0) ? NT(1) / mu_min : -inf;
+        return std::make_pair(t_plus, t_minus);
+    }
+
+    std::pair<NT, NT> lineIntersect(const VT& direction) {
+        setDirection(direction);
+        return intersect();
+    }
+
+    // Move to x + t v along the current direction
+    void move(NT t) {
+        // The point of the last successful factorization is the fallback if
+        // this move ends up outside through round-off
+        safe_x = x;
+        step_direction = v;
+        last_step = t;
+        has_safe_point = true;
+
+        x.noalias() += t * v;
+        if (++moves_since_refresh >= refresh_interval) {
+            combine(x, A);
+            A += A0;
+            moves_since_refresh = 0;
+        } else {
+            A.noalias() += t * B;
+        }
+    }
+
+private:
+    // Cholesky factorization of -A(x), recovering from a point that drifted
+    // outside: rebuild A(x), then halve the last move, then shrink toward the
+    // anchor (the segment to an interior point is interior by convexity)
+    void factorize() {
+        llt.compute(-A);
+        if (llt.info() == Eigen::Success) {
+            return;
+        }
+
+        combine(x, A);
+        A += A0;
+        moves_since_refresh = 0;
+        llt.compute(-A);
+
+        for (int k = 0; k < 10 && llt.info() != Eigen::Success && has_safe_point; k++) {
+            last_step /= NT(2);
+            x = safe_x + last_step * step_direction;
+            combine(x, A);
+            A += A0;
+            llt.compute(-A);
+        }
+        const VT outside = x;
+        NT shrink = NT(1);
+        for (int k = 0; k < 60 && llt.info() != Eigen::Success; k++) {
+            shrink /= NT(2);
+            x = anchor + shrink * (outside - anchor);
+            combine(x, A);
+            A += A0;
+            llt.compute(-A);
+        }
+        has_safe_point = false;
+        if (llt.info() != Eigen::Success) {
+            throw std::runtime_error("LMI oracle point is not strictly inside the spectrahedron");
+        }
+    }
+
+    // Extreme eigenvalues of C from its full dense form
+    void denseExtremes(NT& mu_min, NT& mu_max) {
+        C = B.template selfadjointView<Eigen::Lower>();
+        llt.matrixL().solveInPlace(C);
+        C.transposeInPlace();
+        llt.matrixL().solveInPlace(C);
+
+        eigensolver.compute(C, Eigen::EigenvaluesOnly);
+        mu_max = eigensolver.eigenvalues()(C.rows() - 1);
+        mu_min = eigensolver.eigenvalues()(0);
+    }
+
+    // Whether the chord end t = 1 / mu of an eigenvalue estimate mu is
+    // certified: -(A(x) + t B(v)) has a Cholesky factorization, so x + t v is
+    // strictly inside and, by convexity, so is the chord up to it. A zero mu
+    // (an unbounded end) cannot be certified this way.
+    bool strictlyInside(NT mu) {
+        if (mu == NT(0) || !std::isfinite(mu)) {
+            return false;
+        }
+        C = -(A + (NT(1) / mu) * B);
+        check.compute(C);
+        return check.info() == Eigen::Success;
+    }
+
+    // w = C q = L^-1 B L^-T q
+    void applyC(const VT& q, VT& w) {
+        work = llt.matrixU().solve(q);
+        w.noalias() = B.template selfadjointView<Eigen::Lower>() * work;
+        llt.matrixL().solveInPlace(w);
+    }
+
+    // Extreme eigenvalues of C by Lanczos with full reorthogonalization,
+    // widened by the residual bounds; false if they did not converge
+    bool lanczosExtremes(NT& mu_min, NT& mu_max) {
+        const Eigen::Index m = A.rows();
+        const Eigen::Index max_steps = std::min<Eigen::Index>(m, 80);
+        const NT tol = NT(1e-8);
+
+        basis.resize(m, max_steps);
+        alpha.resize(max_steps);
+        beta.resize(max_steps);
+        basis.col(0) = start;
+
+        for (Eigen::Index k = 0; k < max_steps; k++) {
+            applyC(basis.col(k), w);
+            alpha(k) = basis.col(k).dot(w);
+            w -= alpha(k) * basis.col(k);
+            if (k > 0) {
+                w -= beta(k - 1) * basis.col(k - 1);
+            }
+            w -= basis.leftCols(k + 1) * (basis.leftCols(k + 1).transpose() * w);
+            beta(k) = w.norm();
+
+            const bool last = k + 1 == max_steps;
+            if (k + 1 >= 8 || last) {
+                tridiagonal.computeFromTridiagonal(alpha.head(k + 1), beta.head(k), Eigen::ComputeEigenvectors);
+                const VT& theta = tridiagonal.eigenvalues();
+                const NT scale = std::max(std::abs(theta(0)), std::abs(theta(k)));
+                const NT res_min = std::abs(beta(k) * tridiagonal.eigenvectors()(k, 0));
+                const NT res_max = std::abs(beta(k) * tridiagonal.eigenvectors()(k, k));
+
+                // Each end is needed to a relative accuracy of its own, since
+                // the chord end is 1 / mu. An invariant subspace (beta = 0)
+                // gives exact eigenvalues.
+                const bool converged = res_min <= tol * std::max(std::abs(theta(0)), tol * scale)
+                                    && res_max <= tol * std::max(std::abs(theta(k)), tol * scale);
+                if (converged || beta(k) <= tol * scale) {
+                    mu_min = theta(0) - res_min;
+                    mu_max = theta(k) + res_max;
+                    return true;
+                }
+            }
+            if (last) {
+                break;
+            }
+            basis.col(k + 1) = w / beta(k);
+        }
+        return false;
+    }
+
+    // Lower triangle of M, column by column, into out
+    template <typename Dest>
+    static void pack(const MT& M, Dest&& out) {
+        Eigen::Index row = 0;
+        for (Eigen::Index col = 0; col < M.cols(); col++) {
+            out.segment(row, M.rows() - col) = M.col(col).tail(M.rows() - col);
+            row += M.rows() - col;
+        }
+    }
+
+    // Lower triangle of out = sum_i w_i A_i (the upper triangle is not used)
+    void combine(const VT& w, MT& out) {
+        if (use_sparse) {
+            packed.noalias() = sparse_packed * w;
+        } else {
+            packed.noalias() = dense_packed * w;
+        }
+        const Eigen::Index m = A0.rows();
+        out.resize(m, m);
+        Eigen::Index row = 0;
+        for (Eigen::Index col = 0; col < m; col++) {
+            out.col(col).tail(m - col) = packed.segment(row, m - col);
+            row += m - col;
+        }
+    }
+
+    MT A0;
+    bool use_sparse;
+    MT dense_packed;
+    SpMT sparse_packed;
+
+    VT x;
+    VT v;
+    MT A;  // Lower triangle of A(x)
+    MT B;  // Lower triangle of B(v)
+    MT C;
+    VT packed;
+    Eigen::LLT<MT> llt;
+    Eigen::LLT<MT> check;  // Chord end certification
+    Eigen::SelfAdjointEigenSolver<MT> eigensolver;
+
+    // Lanczos workspace
+    VT start;
+    MT basis;
+    VT alpha;
+    VT beta;
+    VT w;
+    VT work;
+    Eigen::SelfAdjointEigenSolver<MT> tridiagonal;
+
+    // Last move, for recovering from drift
+    VT anchor;
+    VT safe_x;
+    VT step_direction;
+    NT last_step;
+
+    unsigned int refresh_interval;
+    Eigen::Index dense_threshold;
+    unsigned int moves_since_refresh;
+    bool has_safe_point;
+};
+
+#endif // LMI_LINE_ORACLE_H
@@ -0,0 +1,117 @@
+#ifndef LP_SOLVE_CACHE_H
+#define LP_SOLVE_CACHE_H
+
+#include <Eigen/Dense>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "interior_point_lp.h"
+#include "lp_utils.h"
+
+/**
+ * Content-addressed cache in front of InteriorPointLP::solve for workloads
+ * that resubmit the same LPs. Problems are identified by 64-bit hashes of
+ * their data and of the solver parameters that affect the result:
+ *  - an exact repeat of (A, b, c, parameters) returns the stored Result,
+ *    once a second, independent digest of the same data also matches;
+ *  - a problem with the same A and b (and scaling setting) but another c
+ *    reuses the stored scaling factors and starts from the iterate kept at
+ *    the warm-start level as in IncrementalLP, with only its blocking pairs
+ *    shifted. A warm start that has not converged within the iterations of
+ *    the cold solve of that system is abandoned for a cold solve.
+ * Only results with status Optimal or GapReached are stored; the warm-start
+ * point is kept either way. Entries live in an LRU list bounded by
+ * max_bytes. If a directory is given, every entry is also written there and
+ * memory misses are looked up on disk, so the cache survives restarts and
+ * can be shared between processes. The disk store is not bounded: entries
+ * are never removed from it, and it is up to the caller to delete the
+ * directory (or old files in it) when it grows too large.
+ * All methods are thread-safe; solves run outside the lock.
+ */
+class LPSolveCache {
+public:
+    // How a solve was answered
+    enum class Source {
+        Solved,       // Full solve, nothing reusable was cached
+        WarmStarted,  // Solve started from the cached point of the same A and b
+        Cached        // Stored result of an identical problem
+    };
+
+    struct Stats {
+        long long exact_hits = 0;  // Identical problems answered from memory
+        long long disk_hits = 0;   // Identical problems answered from the disk store
+        long long warm_starts = 0; // Solves warm started from a cached point
+        long long misses = 0;      // Solves started from scratch
+        long long evictions = 0;   // Entries dropped from memory by the LRU
+        std::size_t entries = 0;   // Entries currently in memory
+        std::size_t bytes = 0;     // Approximate memory held by those entries
+
+        long long lookups() const { return exact_hits + disk_hits + warm_starts + misses; }
+
+        // Fraction of solves answered without iterating
+        double hitRate() const {
+            return lookups() == 0 ? 0.0 : double(exact_hits + disk_hits) / lookups();
+        }
+    };
+
+    /**
+     * @param max_bytes Memory budget for cached results and warm-start points
+     * @param directory Optional directory for the on-disk store (created if missing, never pruned)
+     */
+    explicit LPSolveCache(std::size_t max_bytes = std::size_t(256) << 20, const std::string& directory = "");
+
+    /**
+     * Solve with the current InteriorPointLP parameters, reusing cached work
+     * @param A The constraint matrix
+     * @param b The right-hand side vector
+     * @param c The objective coefficient vector
+     * @param source If not null, set to how the solve was answered
+     * @return The result; cached results have zero setup and iteration time
+     */
+    InteriorPointLP::Result solve(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, const Eigen::VectorXd& c,
+                                  Source* source = nullptr);
+
+    Stats stats() const;
+
+    // Drop all entries from memory (the disk store is kept) and reset the counters
+    void clear();
+
+private:
+    enum class Kind : std::uint32_t { Result = 1, WarmStart = 2 };
+
+    // A cached result (Kind::Result) or scaling and scaled warm-start point (Kind::WarmStart)
+    struct Entry {
+        std::uint64_t key = 0;
+        Kind kind = Kind::Result;
+        std::uint64_t check = 0;     // Second digest of the problem (Kind::Result)
+        InteriorPointLP::Result result;
+        LPUtils::ScalingInfo scaling;
+        Eigen::VectorXd x, lambda, s;
+        int cold_iterations = 0;     // Iterations of the last converged cold solve (Kind::WarmStart)
+        std::size_t bytes = 0;
+    };
+    typedef std::shared_ptr<const Entry> EntryPtr;
+
+    // Look up an entry in memory, then on disk; counts nothing
+    EntryPtr find(std::uint64_t key, Kind kind, Eigen::Index m, Eigen::Index n, bool& from_disk);
+
+    // Add an entry to memory, evicting as needed, and with persist to the disk store
+    void insert(const std::shared_ptr<Entry>& entry, bool persist);
+
+    std::string entryPath(std::uint64_t key, Kind kind) const;
+    void writeEntry(const Entry& entry) const;
+    std::shared_ptr<Entry> readEntry(std::uint64_t key, Kind kind, Eigen::Index m, Eigen::Index n) const;
+
+    std::size_t max_bytes;
+    std::string directory;
+
+    std::list<EntryPtr> lru;  // Most recently used first
+    std::unordered_map<std::uint64_t, std::list<EntryPtr>::iterator> index;
+    Stats counters;
+    mutable std::mutex mutex;
+};
+
+#endif // LP_SOLVE_CACHE_H
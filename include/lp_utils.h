@@ -3,6 +3,7 @@
 
 #include <Eigen/Dense>
 #include <iostream>
+#include <string>
 
 namespace LPUtils {
 
@@ -24,6 +25,26 @@ struct ScalingInfo {
  */
 ScalingInfo scaleLP(Eigen::MatrixXd& A, Eigen::VectorXd& b, Eigen::VectorXd& c);
 
+/**
+ * Scale rows appended to an already scaled problem. The existing column
+ * scaling is applied first, then each new row gets its own row scaling
+ * factor, which is appended to scaling.row_scaling.
+ * @param A_rows The new constraint rows (k x n), scaled in place
+ * @param b_rows The new right-hand side entries, scaled in place
+ * @param scaling Scaling information from scaleLP
+ */
+void scaleNewRows(Eigen::MatrixXd& A_rows, Eigen::VectorXd& b_rows, ScalingInfo& scaling);
+
+/**
+ * Scale columns appended to an already scaled problem. The existing row
+ * scaling is applied first, then each new column gets its own column
+ * scaling factor, which is appended to scaling.col_scaling.
+ * @param A_cols The new constraint columns (m x k), scaled in place
+ * @param c_cols The new objective coefficients, scaled in place
+ * @param scaling Scaling information from scaleLP
+ */
+void scaleNewColumns(Eigen::MatrixXd& A_cols, Eigen::VectorXd& c_cols, ScalingInfo& scaling);
+
 /**
  * Rescale the solution back to the original problem
  * @param x Primal variables
@@ -34,6 +55,22 @@ ScalingInfo scaleLP(Eigen::MatrixXd& A, Eigen::VectorXd& b, Eigen::VectorXd& c);
 void rescaleSolution(Eigen::VectorXd& x, Eigen::VectorXd& lambda, Eigen::VectorXd& s, 
                       const ScalingInfo& scaling);
 
+/**
+ * Read a linear programming problem from a text file. Format:
+ * line 1 holds the number of variables and constraints, line 2 the
+ * objective coefficients, followed by one line per constraint row and
+ * a final line with the right-hand side.
+ * @param filename Path to the LP file
+ * @param A Constraint matrix (output)
+ * @param b Right-hand side vector (output)
+ * @param c Objective coefficient vector (output)
+ * @param numVars Number of variables (output)
+ * @param numConstraints Number of constraints (output)
+ * @throws std::runtime_error if the file cannot be opened or parsed
+ */
+void readLPData(const std::string& filename, Eigen::MatrixXd& A, Eigen::VectorXd& b, Eigen::VectorXd& c,
+                int& numVars, int& numConstraints);
+
 /**
  * Check if a vector contains NaN or Infinity values
  * @param vec The vector to check
@@ -0,0 +1,196 @@
+#ifndef ONLINE_DIAGNOSTICS_H
+#define ONLINE_DIAGNOSTICS_H
+
+#include <Eigen/Dense>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Convergence target for adaptive stopping of multi-chain sampling
+ */
+struct ConvergenceTarget {
+    double max_psrf = 1.1;   // Stop once the largest univariate PSRF is below this value
+    double min_ess = 0.0;    // ... and the smallest per-coordinate ESS (summed over chains) reaches this
+};
+
+/**
+ * Running statistics of a single chain, updated in O(d) per sample.
+ * Mean and variance use Welford's recurrence. The effective sample size is
+ * estimated with batch means: batch averages are kept in a fixed number of
+ * slots, and when all slots are used adjacent batches are merged and the
+ * batch size doubles, so memory stays at O(d * num_batches).
+ */
+template <typename NT>
+class OnlineChainStats {
+public:
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, 1> VT;
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, Eigen::Dynamic> MT;
+
+    OnlineChainStats(Eigen::Index d = 0, unsigned int num_batches = 32)
+        : n(0), mean(VT::Zero(d)), m2(VT::Zero(d)), delta(VT::Zero(d)),
+          batch_sum(VT::Zero(d)), batch_means(d, 2 * num_batches),
+          batch_size(1), batch_fill(0), filled_batches(0)
+    {
+        if (num_batches < 2) {
+            throw std::invalid_argument("At least two batches are needed for ESS");
+        }
+    }
+
+    template <typename Derived>
+    void update(const Eigen::MatrixBase<Derived>& x) {
+        n++;
+        delta.noalias() = x - mean;
+        mean.noalias() += delta / NT(n);
+        m2.array() += delta.array() * (x - mean).array();
+
+        batch_sum += x;
+        if (++batch_fill == batch_size) {
+            batch_means.col(filled_batches++) = batch_sum / NT(batch_size);
+            batch_sum.setZero();
+            batch_fill = 0;
+
+            if (filled_batches == batch_means.cols()) {
+                const Eigen::Index half = batch_means.cols() / 2;
+                for (Eigen::Index i = 0; i < half; i++) {
+                    batch_means.col(i) = (batch_means.col(2 * i) + batch_means.col(2 * i + 1)) / NT(2);
+                }
+                filled_batches = half;
+                batch_size *= 2;
+            }
+        }
+    }
+
+    long long count() const { return n; }
+    const VT& getMean() const { return mean; }
+
+    VT variance() const {
+        if (n < 2) {
+            return VT::Zero(mean.size());
+        }
+        return m2 / NT(n - 1);
+    }
+
+    // Per-coordinate effective sample size, capped at the number of samples
+    VT ess() const {
+        if (filled_batches < 2) {
+            return VT::Zero(mean.size());
+        }
+        auto batches = batch_means.leftCols(filled_batches);
+        VT batch_var = (batches.colwise() - batches.rowwise().mean()).rowwise().squaredNorm()
+                       / NT(filled_batches - 1);
+        VT var = variance();
+
+        VT result(mean.size());
+        for (Eigen::Index i = 0; i < mean.size(); i++) {
+            NT sigma2 = NT(batch_size) * batch_var(i);
+            result(i) = sigma2 > 0 ? std::min(NT(n), NT(n) * var(i) / sigma2) : NT(n);
+        }
+        return result;
+    }
+
+private:
+    long long n;
+    VT mean;
+    VT m2;
+    VT delta;
+    VT batch_sum;
+    MT batch_means;
+    long long batch_size;
+    long long batch_fill;
+    Eigen::Index filled_batches;
+};
+
+/**
+ * Combines the running statistics of several chains into the Gelman-Rubin
+ * PSRF and a total ESS. Chains keep their own OnlineChainStats and publish a
+ * snapshot every few samples, so the per-sample work stays O(d) and the
+ * combination cost is paid once per publish. All methods are thread-safe.
+ */
+template <typename NT>
+class MultiChainMonitor {
+public:
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, 1> VT;
+
+    MultiChainMonitor(unsigned int num_chains, Eigen::Index d, unsigned int num_batches = 32)
+        : snapshots(num_chains, OnlineChainStats<NT>(d, num_batches)) {}
+
+    void publish(unsigned int chain, const OnlineChainStats<NT>& stats) {
+        std::lock_guard<std::mutex> lock(mutex);
+        snapshots[chain] = stats;
+    }
+
+    VT psrf() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return psrfUnlocked();
+    }
+
+    VT ess() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return essUnlocked();
+    }
+
+    // Fewest points published by any chain
+    long long minCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return minCountUnlocked();
+    }
+
+    bool converged(const ConvergenceTarget& target) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return psrfUnlocked().maxCoeff() < target.max_psrf
+            && essUnlocked().minCoeff() >= target.min_ess;
+    }
+
+private:
+    long long minCountUnlocked() const {
+        long long n = std::numeric_limits<long long>::max();
+        for (const OnlineChainStats<NT>& stats : snapshots) {
+            n = std::min(n, stats.count());
+        }
+        return n;
+    }
+
+    VT psrfUnlocked() const {
+        const Eigen::Index d = snapshots.front().getMean().size();
+        const NT chains = NT(snapshots.size());
+
+        const long long n = minCountUnlocked();
+        if (snapshots.size() < 2 || n < 2) {
+            return VT::Constant(d, std::numeric_limits<NT>::infinity());
+        }
+
+        VT grand_mean = VT::Zero(d);
+        VT within = VT::Zero(d);
+        for (const OnlineChainStats<NT>& stats : snapshots) {
+            grand_mean += stats.getMean();
+            within += stats.variance();
+        }
+        grand_mean /= chains;
+        within /= chains;
+
+        VT between_over_n = VT::Zero(d);
+        for (const OnlineChainStats<NT>& stats : snapshots) {
+            between_over_n.array() += (stats.getMean() - grand_mean).array().square();
+        }
+        between_over_n /= chains - 1;
+
+        VT var_plus = (NT(n - 1) / NT(n)) * within + between_over_n;
+        return (var_plus.array() / within.array()).sqrt().matrix();
+    }
+
+    VT essUnlocked() const {
+        VT total = VT::Zero(snapshots.front().getMean().size());
+        for (const OnlineChainStats<NT>& stats : snapshots) {
+            total += stats.ess();
+        }
+        return total;
+    }
+
+    std::vector<OnlineChainStats<NT>> snapshots;
+    mutable std::mutex mutex;
+};
+
+#endif // ONLINE_DIAGNOSTICS_H
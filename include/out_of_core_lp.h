@@ -0,0 +1,65 @@
+#ifndef OUT_OF_CORE_LP_H
+#define OUT_OF_CORE_LP_H
+
+#include <Eigen/Dense>
+#include "column_block_matrix.h"
+#include "interior_point_lp.h"
+#include "lp_utils.h"
+
+/**
+ * Interior point solver for min c^T x s.t. Ax = b, x >= 0 when A does not fit
+ * in memory but the m x m normal matrix does. A stays in a column block file
+ * (ColumnBlockMatrix) and is only ever read one block at a time: A x, A^T y
+ * and A D A^T are accumulated block by block while the next block is read
+ * ahead, so peak memory is O(m^2 + m * block_cols) plus vectors of length n.
+ *
+ * The iteration is the PredictorCorrector loop of InteriorPointLP::solve
+ * with its parameters, anytime mode included (each pair of bounds costs a
+ * few extra passes over A). Scaling is applied implicitly (A is never
+ * modified), and the residuals and A D A^T share one pass over A. With
+ * split_dense_columns, a sparse A with a few dense columns is detected with
+ * one counting pass and factored in the split form of InteriorPointLP: the
+ * dense columns (fewer than m) are kept in memory, and the sparse part of
+ * the normal matrix is accumulated block by block in the residual pass, so
+ * the split path stays within O(m^2) memory as well. The fixed-size
+ * kernels are not used on this path.
+ */
+class OutOfCoreLP {
+public:
+    /**
+     * Solve the LP with A read from a column block file
+     * @param A The constraint matrix
+     * @param b The right-hand side vector
+     * @param c The objective coefficient vector
+     * @return The result in terms of the unscaled problem
+     */
+    static InteriorPointLP::Result solve(const ColumnBlockMatrix& A, const Eigen::VectorXd& b,
+                                         const Eigen::VectorXd& c);
+
+private:
+    // Row and column equilibration as in LPUtils::scaleLP, computed with
+    // streamed passes; b and c are scaled in place
+    static LPUtils::ScalingInfo computeScaling(const ColumnBlockMatrix& A, Eigen::VectorXd& b, Eigen::VectorXd& c);
+
+    // One pass over A: rb = A_s x - b and rc = A_s^T lambda + s - c for the
+    // scaled matrix A_s, and, if d is non-null, the normal matrix for
+    // D = diag(d): A_s D A_s^T into normal, or with ne.use_sparse the sparse
+    // part M_sparse and d_dense of the split form into ne
+    static void residualsAndNormal(
+        const ColumnBlockMatrix& A, const LPUtils::ScalingInfo& scaling,
+        const Eigen::VectorXd& b, const Eigen::VectorXd& c,
+        const Eigen::VectorXd& x, const Eigen::VectorXd& lambda, const Eigen::VectorXd& s,
+        const Eigen::VectorXd* d, Eigen::VectorXd& rb, Eigen::VectorXd& rc,
+        InteriorPointLP::NormalEquations& ne, Eigen::MatrixXd& normal);
+
+    // Detect dense columns as InteriorPointLP does and, if the split pays
+    // off, gather the scaled dense columns into ne
+    static void analyzeNormalEquations(const ColumnBlockMatrix& A, const LPUtils::ScalingInfo& scaling,
+                                       const InteriorPointLP::Parameters& params,
+                                       InteriorPointLP::NormalEquations& ne);
+
+    // PredictorCorrector backend (defined in out_of_core_lp.cpp)
+    struct Backend;
+};
+
+#endif // OUT_OF_CORE_LP_H
@@ -0,0 +1,402 @@
+#ifndef PREDICTOR_CORRECTOR_H
+#define PREDICTOR_CORRECTOR_H
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include "interior_point_lp.h"
+
+/**
+ * The Mehrotra predictor-corrector iteration behind InteriorPointLP,
+ * TinyLP and OutOfCoreLP, including the anytime mode (bounds on the optimal
+ * value, time_budget and gap_target). Everything that touches A is left to a
+ * backend, which provides:
+ *
+ *   typedef ... VectorM, VectorN;  vectors of length m and n
+ *   const VectorM& b() const;      right-hand side and objective of the
+ *   const VectorN& c() const;      (scaled) problem
+ *   void multiply(const VectorN& v, VectorM& out);           out = A v
+ *   void multiplyTranspose(const VectorM& y, VectorN& out);  out = A^T y
+ *   void residuals(x, lambda, s, const VectorN* d, VectorM& rb, VectorN& rc);
+ *       rb = A x - b and rc = A^T lambda + s - c. If d is not null, the
+ *       next factor() call is for this d, so a backend may form A D A^T in
+ *       the same pass over A.
+ *   bool factor(const VectorN& d);               factor A D A^T + regularization
+ *   bool solve(const VectorM& rhs, VectorM& y);  y = (A D A^T)^-1 rhs, last factorization
+ *   double unscaledNorm(const VectorM& r) const;
+ *       Norm of a residual r = A x - b of the (scaled) problem in the units
+ *       of the original one, where it is compared with the original b.
+ *
+ * The normal matrix is factored once per iteration and shared by the
+ * predictor, the corrector and the bounds. All vectors keep
+ * the backend's types, so a fixed-size backend runs without heap allocation.
+ */
+template <typename Backend>
+class PredictorCorrector {
+public:
+    typedef typename Backend::VectorM VectorM;
+    typedef typename Backend::VectorN VectorN;
+    typedef InteriorPointLP::Status Status;
+
+    // Best bounds on the optimal value found so far in anytime mode. lambda
+    // has c - A^T lambda >= 0, so its dual objective lower is a certified
+    // bound. x is a nonnegative point that satisfies A x = b to 1e-2 tol in
+    // the original units, so its objective upper holds to the same
+    // feasibility tolerance as a converged solution. lower <= upper always:
+    // an upper bound that a later lower bound overtakes is dropped. Each
+    // point is only meaningful while its bound is finite.
+    struct Bounds {
+        double lower = -std::numeric_limits<double>::infinity();
+        double upper = std::numeric_limits<double>::infinity();
+        VectorN x;
+        VectorM lambda;
+
+        // (upper - lower) / max(1, |upper|), infinite until both sides are known
+        double relativeGap() const {
+            if (!std::isfinite(lower) || !std::isfinite(upper)) {
+                return std::numeric_limits<double>::infinity();
+            }
+            return std::max(0.0, upper - lower) / std::max(1.0, std::fabs(upper));
+        }
+    };
+
+    struct Outcome {
+        Status status = Status::IterationLimit;
+        int iterations = 0;
+        Bounds bounds;
+    };
+
+    // Starting point x = e, lambda = 0 and s = c shifted to be positive,
+    // scaled so that the complementarity products average out at 1 (10 for
+    // more than 1000 variables)
+    static void initialPoint(const VectorN& c, Eigen::Index m, VectorN& x, VectorM& lambda, VectorN& s) {
+        const Eigen::Index n = c.size();
+        x.setOnes(n);
+        lambda.setZero(m);
+        s = c;
+
+        double min_s = s.minCoeff();
+        if (min_s <= 1e-2) {
+            s.array() -= min_s - 1.0;
+        }
+
+        double scaling_target = n > 1000 ? 10.0 : 1.0;
+        double geo_mean = std::pow((x.array() * s.array()).prod(), 1.0 / n);
+        if (!std::isfinite(geo_mean) || geo_mean < 1e-10) {
+            geo_mean = 1.0;
+        }
+
+        double scale_factor = std::sqrt(scaling_target / geo_mean);
+        x *= scale_factor;
+        s /= scale_factor;
+    }
+
+    /**
+     * Iterate from (x, lambda, s) with x > 0 and s > 0 until convergence or
+     * another stop. The last iterate is left in x, lambda and s, and its
+     * residuals in rb and rc.
+     * @param b_norm, c_norm Norms of the unscaled b and c for the relative tolerances
+     * @param time_left Seconds left of params.time_budget when the call starts
+     * @param snapshot If not null and not yet taken, receives the first iterate that meets its levels
+     */
+    static Outcome run(Backend& backend, const InteriorPointLP::Parameters& params,
+                       VectorN& x, VectorM& lambda, VectorN& s, VectorM& rb, VectorN& rc,
+                       double b_norm, double c_norm, double time_left,
+                       InteriorPointLP::Snapshot* snapshot = nullptr)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        const Eigen::Index n = x.size();
+        const Eigen::Index m = lambda.size();
+
+        // In anytime mode every iterate is checked for bounds, and the loop
+        // stops at the time budget or once their relative gap is small enough
+        const bool anytime = params.time_budget > 0 || params.gap_target > 0;
+        const Clock::time_point start = anytime ? Clock::now() : Clock::time_point();
+
+        Outcome outcome;
+        VectorN d(n), rhs3(n), dx_aff(n), ds_aff(n), dx(n), ds(n);
+        VectorM dlambda_aff(m), dlambda(m);
+        rb.resize(m);
+        rc.resize(n);
+
+        int iter = 0;
+        while (true) {
+            if (!x.allFinite() || !lambda.allFinite() || !s.allFinite()) {
+                outcome.status = Status::Breakdown;
+                break;
+            }
+
+            const double mu = x.dot(s) / n;
+            scalingDiagonal(x, s, d);
+            backend.residuals(x, lambda, s, &d, rb, rc);
+            if (snapshot && !snapshot->taken &&
+                n * mu <= snapshot->gap * (1.0 + std::fabs(backend.c().dot(x))) &&
+                rb.norm() / (1.0 + b_norm) <= snapshot->residual &&
+                rc.norm() / (1.0 + c_norm) <= snapshot->residual) {
+                snapshot->x = x;
+                snapshot->lambda = lambda;
+                snapshot->s = s;
+                snapshot->taken = true;
+            }
+
+            const bool converged = rb.norm() / (1.0 + b_norm) < params.tol &&
+                                   rc.norm() / (1.0 + c_norm) < params.tol && mu < params.tol;
+            if (converged && !anytime) {
+                outcome.status = Status::Optimal;
+                break;
+            }
+            if (!converged && iter >= params.max_iter) {
+                outcome.status = Status::IterationLimit;
+                break;
+            }
+
+            // Normal matrix A D A^T, shared by the bounds, predictor and corrector
+            if (!backend.factor(d)) {
+                outcome.status = Status::Breakdown;
+                break;
+            }
+
+            if (anytime) {
+                updateBounds(backend, params, x, lambda, d, rb, rc, b_norm, outcome.bounds);
+                if (converged) {
+                    outcome.status = Status::Optimal;
+                    break;
+                }
+                if (params.gap_target > 0 && outcome.bounds.relativeGap() <= params.gap_target) {
+                    outcome.status = Status::GapReached;
+                    break;
+                }
+                if (params.time_budget > 0 &&
+                    std::chrono::duration<double>(Clock::now() - start).count() >= time_left) {
+                    outcome.status = Status::TimeLimit;
+                    break;
+                }
+            }
+
+            // Predictor
+            rhs3 = -(x.array() * s.array()).matrix();
+            if (!solveNewton(backend, d, x, s, rc, rb, rhs3, dx_aff, dlambda_aff, ds_aff)) {
+                outcome.status = Status::Breakdown;
+                break;
+            }
+
+            double alpha_pri_aff, alpha_dual_aff;
+            stepLengths(x, s, dx_aff, ds_aff, alpha_pri_aff, alpha_dual_aff);
+            double sigma = centering(x, s, dx_aff, ds_aff, alpha_pri_aff, alpha_dual_aff, mu);
+
+            // Corrector
+            for (Eigen::Index i = 0; i < n; i++) {
+                double corrector = (std::fabs(dx_aff(i)) > 1e6 || std::fabs(ds_aff(i)) > 1e6)
+                                   ? 0.0 : dx_aff(i) * ds_aff(i);
+                rhs3(i) = -x(i) * s(i) - corrector + sigma * mu;
+            }
+            if (!solveNewton(backend, d, x, s, rc, rb, rhs3, dx, dlambda, ds)) {
+                outcome.status = Status::Breakdown;
+                break;
+            }
+
+            double alpha_pri, alpha_dual;
+            stepLengths(x, s, dx, ds, alpha_pri, alpha_dual);
+            double eta_factor = n > 1000 ? std::min(0.7, params.eta) : params.eta;
+            alpha_pri = std::min(1.0, eta_factor * alpha_pri);
+            alpha_dual = std::min(1.0, eta_factor * alpha_dual);
+
+            x += alpha_pri * dx;
+            lambda += alpha_dual * dlambda;
+            s += alpha_dual * ds;
+
+            iter++;
+        }
+
+        if (outcome.status == Status::Breakdown) {
+            backend.residuals(x, lambda, s, nullptr, rb, rc);
+        }
+        outcome.iterations = iter;
+        return outcome;
+    }
+
+    /**
+     * Replace (x, lambda, s) and its residuals by the best bound points of an
+     * anytime run: the nearly feasible x of the upper bound, with the
+     * multipliers of the lower bound and their reduced costs if the lower
+     * bound is known too. Without an upper bound the last iterate stays, and
+     * the lower bound is lowered to its objective if that is smaller, so that
+     * lower <= c^T x <= upper holds for the returned x either way.
+     * @return False (and x, lambda, s unchanged) if no upper bound was found
+     */
+    static bool useAnytimePoint(Backend& backend, Outcome& outcome,
+                                VectorN& x, VectorM& lambda, VectorN& s, VectorM& rb, VectorN& rc)
+    {
+        if (!std::isfinite(outcome.bounds.upper)) {
+            outcome.bounds.lower = std::min(outcome.bounds.lower, backend.c().dot(x));
+            return false;
+        }
+        x = outcome.bounds.x;
+        if (std::isfinite(outcome.bounds.lower)) {
+            lambda = outcome.bounds.lambda;
+            backend.multiplyTranspose(lambda, s);
+            s = backend.c() - s;
+        }
+        backend.residuals(x, lambda, s, nullptr, rb, rc);
+        return true;
+    }
+
+private:
+    // Scaling diagonal D = X S^-1 of the normal equations, clamped
+    static void scalingDiagonal(const VectorN& x, const VectorN& s, VectorN& d) {
+        for (Eigen::Index i = 0; i < x.size(); i++) {
+            d(i) = x(i) / (s(i) < 1e-14 ? 1e-14 : s(i));
+            d(i) = std::min(std::max(d(i), 1e-12), 1e12);
+        }
+    }
+
+    // Solve the Newton system for rhs (-rc, -rb, rhs3) with the factored normal matrix
+    static bool solveNewton(Backend& backend, const VectorN& d, const VectorN& x, const VectorN& s,
+                            const VectorN& rc, const VectorM& rb, const VectorN& rhs3,
+                            VectorN& dx, VectorM& dlambda, VectorN& ds)
+    {
+        const Eigen::Index n = x.size();
+        VectorN rhs_temp(n);
+        for (Eigen::Index i = 0; i < n; i++) {
+            rhs_temp(i) = rhs3(i) / (std::fabs(s(i)) < 1e-14 ? 1e-14 : s(i));
+            rhs_temp(i) = std::min(std::max(rhs_temp(i), -1e12), 1e12);
+        }
+
+        // dx = D (A^T dlambda + rc) + S^-1 rhs3, so A dx = -rb needs
+        // A D A^T dlambda = -rb - A (S^-1 rhs3 + D rc)
+        VectorN v = rhs_temp + d.cwiseProduct(rc);
+        VectorM rhs_lambda(rb.size());
+        backend.multiply(v, rhs_lambda);
+        rhs_lambda = -rb - rhs_lambda;
+        if (!rhs_lambda.allFinite() || !backend.solve(rhs_lambda, dlambda) || !dlambda.allFinite()) {
+            return false;
+        }
+
+        backend.multiplyTranspose(dlambda, dx);
+        dx = d.cwiseProduct(dx + rc) + rhs_temp;
+        for (Eigen::Index i = 0; i < n; i++) {
+            ds(i) = (rhs3(i) - s(i) * dx(i)) / (x(i) < 1e-12 ? 1e-12 : x(i));
+            ds(i) = std::min(std::max(ds(i), -1e12), 1e12);
+        }
+        return true;
+    }
+
+    static void stepLengths(const VectorN& x, const VectorN& s, const VectorN& dx, const VectorN& ds,
+                            double& alpha_pri, double& alpha_dual)
+    {
+        alpha_pri = 1.0;
+        alpha_dual = 1.0;
+        for (Eigen::Index i = 0; i < x.size(); i++) {
+            if (dx(i) < -1e-12) {
+                double ratio = -x(i) / dx(i);
+                if (std::isfinite(ratio) && ratio < alpha_pri) alpha_pri = ratio;
+            }
+            if (ds(i) < -1e-12) {
+                double ratio = -s(i) / ds(i);
+                if (std::isfinite(ratio) && ratio < alpha_dual) alpha_dual = ratio;
+            }
+        }
+        if (!std::isfinite(alpha_pri) || alpha_pri < 0) alpha_pri = 0;
+        if (!std::isfinite(alpha_dual) || alpha_dual < 0) alpha_dual = 0;
+    }
+
+    // Mehrotra's centering parameter (mu_aff / mu)^3, clamped to [0.01, 0.5]
+    static double centering(const VectorN& x, const VectorN& s, const VectorN& dx_aff, const VectorN& ds_aff,
+                            double alpha_pri_aff, double alpha_dual_aff, double mu)
+    {
+        double mu_aff = 0.0;
+        int count = 0;
+        for (Eigen::Index i = 0; i < x.size(); i++) {
+            double x_new = x(i) + alpha_pri_aff * dx_aff(i);
+            double s_new = s(i) + alpha_dual_aff * ds_aff(i);
+            if (x_new > 0 && s_new > 0) {
+                mu_aff += x_new * s_new;
+                count++;
+            }
+        }
+        mu_aff = count == 0 ? mu : mu_aff / count;
+
+        if (mu_aff < 1e-14) mu_aff = 1e-14;
+        if (mu < 1e-14) mu = 1e-14;
+
+        double sigma = std::pow(mu_aff / mu, 3);
+        return std::min(std::max(sigma, 0.01), 0.5);
+    }
+
+    // Derive bounds from the current iterate and keep the best ones
+    static void updateBounds(Backend& backend, const InteriorPointLP::Parameters& params,
+                             const VectorN& x, const VectorM& lambda, const VectorN& d,
+                             const VectorM& rb, const VectorN& rc, double b_norm, Bounds& bounds)
+    {
+        // The scaled objectives equal the original ones (c_s^T x_s = c^T x and
+        // b_s^T lambda_s = b^T lambda), so the bounds are computed in scaled space.
+        const VectorM& b = backend.b();
+        const VectorN& c = backend.c();
+        VectorN z(x.size());
+        VectorM y(lambda.size()), r(lambda.size());
+
+        // Lower bound: weak duality gives c^T x >= b^T lambda for every feasible x
+        // whenever c - A^T lambda >= 0. Try lambda itself, then lambda corrected by
+        // the weighted least-squares step that removes the dual residual as far
+        // as A^T can: A D A^T delta = -A D rc.
+        backend.multiplyTranspose(lambda, z);
+        if ((c - z).minCoeff() >= 0) {
+            double lower = b.dot(lambda);
+            if (lower > bounds.lower) {
+                bounds.lower = lower;
+                bounds.lambda = lambda;
+            }
+        } else {
+            z = d.cwiseProduct(rc);
+            backend.multiply(z, r);
+            r = -r;
+            if (backend.solve(r, y)) {
+                VectorM lambda_c = lambda + y;
+                backend.multiplyTranspose(lambda_c, z);
+                if ((c - z).minCoeff() >= 0) {
+                    double lower = b.dot(lambda_c);
+                    if (lower > bounds.lower) {
+                        bounds.lower = lower;
+                        bounds.lambda = lambda_c;
+                    }
+                }
+            }
+        }
+
+        // Upper bound: move x onto A x = b with the D-weighted projection
+        // x - D A^T (A D A^T)^-1 (A x - b), plus one refinement step. The step is
+        // small relative to x where x_i / s_i is small, so positivity survives
+        // once the primal residual is small. The point is accepted only if its
+        // residual, measured against the original b, is well inside tol, and
+        // never below the certified lower bound, where its objective would owe
+        // more to the residual than to the LP.
+        // The certified lower bound wins over an upper bound it overtook
+        if (bounds.lower > bounds.upper) {
+            bounds.upper = std::numeric_limits<double>::infinity();
+        }
+
+        VectorN x_p = x;
+        r = rb;
+        for (int k = 0; k < 2; k++) {
+            if (!backend.solve(r, y)) {
+                break;
+            }
+            backend.multiplyTranspose(y, z);
+            x_p -= d.cwiseProduct(z);
+            backend.multiply(x_p, r);
+            r -= b;
+        }
+        if (x_p.minCoeff() >= 0 && backend.unscaledNorm(r) / (1.0 + b_norm) <= 1e-2 * params.tol) {
+            double upper = c.dot(x_p);
+            if (upper < bounds.upper && upper >= bounds.lower) {
+                bounds.upper = upper;
+                bounds.x = x_p;
+            }
+        }
+    }
+};
+
+#endif // PREDICTOR_CORRECTOR_H
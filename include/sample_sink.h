@@ -0,0 +1,203 @@
+#ifndef SAMPLE_SINK_H
+#define SAMPLE_SINK_H
+
+#include <Eigen/Dense>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Destination for samples produced by a random walk. Chains hand over
+ * fixed-size blocks of points (one point per column) as they produce them,
+ * so memory stays bounded by the block size instead of the run length.
+ * write_block may be called concurrently from several chains.
+ */
+template <typename MT>
+class SampleSink {
+public:
+    virtual ~SampleSink() = default;
+
+    /**
+     * Consume the first count columns of block
+     * @param chain Index of the chain that produced the block
+     * @param block Points, one per column (a plain matrix or a block of columns)
+     * @param count Number of valid columns in block
+     */
+    virtual void write_block(unsigned int chain, const Eigen::Ref<const MT>& block, Eigen::Index count) = 0;
+
+    // Flush buffered output to the underlying storage
+    virtual void flush() {}
+};
+
+/**
+ * Compact binary sink. Layout (native endianness):
+ *   header: char[4] "SMPL", uint32 version, uint32 dimension, uint32 sizeof(scalar)
+ *   blocks: uint32 chain, uint32 count, count * dimension scalars (point by point)
+ * A contiguous block is written with one call, so the column-major block maps
+ * directly onto the file without any reordering.
+ */
+template <typename MT>
+class BinarySampleSink : public SampleSink<MT> {
+public:
+    typedef typename MT::Scalar NT;
+
+    BinarySampleSink(const std::string& filename, unsigned int dimension)
+        : out(filename, std::ios::binary), dim(dimension)
+    {
+        if (!out) {
+            throw std::runtime_error("Failed to open file: " + filename);
+        }
+        const std::uint32_t header[3] = {1u, std::uint32_t(dim), std::uint32_t(sizeof(NT))};
+        out.write("SMPL", 4);
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    }
+
+    void write_block(unsigned int chain, const Eigen::Ref<const MT>& block, Eigen::Index count) override {
+        if (block.rows() != dim) {
+            throw std::invalid_argument("Block dimension does not match sink dimension");
+        }
+        const std::uint32_t record[2] = {std::uint32_t(chain), std::uint32_t(count)};
+        std::lock_guard<std::mutex> lock(mutex);
+        out.write(reinterpret_cast<const char*>(record), sizeof(record));
+        if (block.outerStride() == dim) {
+            out.write(reinterpret_cast<const char*>(block.data()), sizeof(NT) * dim * count);
+        } else {
+            for (Eigen::Index j = 0; j < count; j++) {
+                out.write(reinterpret_cast<const char*>(block.col(j).data()), sizeof(NT) * dim);
+            }
+        }
+    }
+
+    void flush() override {
+        std::lock_guard<std::mutex> lock(mutex);
+        out.flush();
+    }
+
+private:
+    std::ofstream out;
+    Eigen::Index dim;
+    std::mutex mutex;
+};
+
+/**
+ * CSV sink with one point per line: "chain,x_0,...,x_{d-1}". Numbers are
+ * formatted with std::to_chars into a local buffer (shortest round-trip
+ * representation), and each block is emitted with a single write.
+ */
+template <typename MT>
+class CsvSampleSink : public SampleSink<MT> {
+public:
+    CsvSampleSink(const std::string& filename, unsigned int dimension)
+        : out(filename)
+    {
+        if (!out) {
+            throw std::runtime_error("Failed to open file: " + filename);
+        }
+        out << "chain";
+        for (unsigned int i = 0; i < dimension; i++) {
+            out << ",x" << i;
+        }
+        out << "\n";
+    }
+
+    void write_block(unsigned int chain, const Eigen::Ref<const MT>& block, Eigen::Index count) override {
+        // Worst case for a double in shortest form is 24 characters plus separator
+        std::vector<char> buffer(std::size_t(count) * (12 + 25 * block.rows()));
+        char* pos = buffer.data();
+        char* const last = buffer.data() + buffer.size();
+
+        for (Eigen::Index j = 0; j < count; j++) {
+            pos = std::to_chars(pos, last, chain).ptr;
+            for (Eigen::Index i = 0; i < block.rows(); i++) {
+                *pos++ = ',';
+                pos = std::to_chars(pos, last, block(i, j)).ptr;
+            }
+            *pos++ = '\n';
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        out.write(buffer.data(), pos - buffer.data());
+    }
+
+    void flush() override {
+        std::lock_guard<std::mutex> lock(mutex);
+        out.flush();
+    }
+
+private:
+    std::ofstream out;
+    std::mutex mutex;
+};
+
+/**
+ * Forwards every block to two sinks, e.g. to keep a CSV and a binary copy
+ */
+template <typename MT>
+class TeeSampleSink : public SampleSink<MT> {
+public:
+    TeeSampleSink(SampleSink<MT>& first_, SampleSink<MT>& second_)
+        : first(first_), second(second_) {}
+
+    void write_block(unsigned int chain, const Eigen::Ref<const MT>& block, Eigen::Index count) override {
+        first.write_block(chain, block, count);
+        second.write_block(chain, block, count);
+    }
+
+    void flush() override {
+        first.flush();
+        second.flush();
+    }
+
+private:
+    SampleSink<MT>& first;
+    SampleSink<MT>& second;
+};
+
+/**
+ * Point container that buffers samples in a fixed-size block and hands the
+ * block to a sink whenever it fills up. Call finish() after sampling to
+ * write out a partially filled block.
+ */
+template <typename MT, typename Point>
+class BlockedSinkWriter {
+public:
+    BlockedSinkWriter(SampleSink<MT>& sink_, unsigned int chain_, Eigen::Index dimension,
+                      Eigen::Index block_size)
+        : sink(sink_), chain(chain_), block(dimension, block_size), filled(0), written(0) {}
+
+    void push_back(const Point& p) {
+        block.col(filled++) = p.getCoefficients();
+        if (filled == block.cols()) {
+            emit();
+        }
+    }
+
+    void finish() {
+        if (filled > 0) {
+            emit();
+        }
+        sink.flush();
+    }
+
+    // Number of points handed over to the sink so far
+    Eigen::Index size() const { return written + filled; }
+
+private:
+    void emit() {
+        sink.write_block(chain, block, filled);
+        written += filled;
+        filled = 0;
+    }
+
+    SampleSink<MT>& sink;
+    unsigned int chain;
+    MT block;
+    Eigen::Index filled;
+    Eigen::Index written;
+};
+
+#endif // SAMPLE_SINK_H
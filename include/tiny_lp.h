@@ -0,0 +1,155 @@
+#ifndef TINY_LP_H
+#define TINY_LP_H
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "interior_point_lp.h"
+#include "predictor_corrector.h"
+
+// Largest problem sizes handled by the runtime dispatch in solveTinyLP
+#ifndef TINY_LP_MAX_ROWS
+#define TINY_LP_MAX_ROWS 6
+#endif
+#ifndef TINY_LP_MAX_COLS
+#define TINY_LP_MAX_COLS 12
+#endif
+
+// (m, n) pairs that get an exact fixed-size kernel in solveTinyLP; other sizes
+// within the bounds share one kernel with bounded dynamic sizes. Each entry
+// adds about 10 s of build time, so by default only the shape of
+// data/feasible_lp105.txt is listed. Override with e.g.
+// -DTINY_LP_FIXED_SIZES(X)="X(3, 6) X(5, 10)"
+#ifndef TINY_LP_FIXED_SIZES
+#define TINY_LP_FIXED_SIZES(X) X(5, 10)
+#endif
+
+/**
+ * Interior point kernel for LPs whose dimensions are known at compile time.
+ * M and N may also be Eigen::Dynamic with the bounds MaxM and MaxN, which
+ * keeps the storage on the stack for any size up to the bounds. It runs the
+ * PredictorCorrector iteration of InteriorPointLP::solve (anytime mode
+ * included) with a backend in which all vectors and the M x M normal matrix
+ * are fixed-size Eigen types on the stack and the factorization is unrolled
+ * by the compiler. No heap allocation, exceptions or output on this path.
+ * Scaling is skipped, as scaleLP does for problems of this size.
+ */
+template <int M, int N, int MaxM = M, int MaxN = N>
+class TinyLP {
+public:
+    typedef Eigen::Matrix<double, M, N, 0, MaxM, MaxN> MatrixA;
+    typedef Eigen::Matrix<double, M, M, 0, MaxM, MaxM> MatrixM;
+    typedef Eigen::Matrix<double, M, 1, 0, MaxM, 1> VectorM;
+    typedef Eigen::Matrix<double, N, 1, 0, MaxN, 1> VectorN;
+
+    // Solution and statistics of a tiny solve
+    struct Solution {
+        bool success = false;
+        VectorN x;
+        VectorM lambda;
+        VectorN s;
+        double optimal_value = 0.0;
+        double primal_infeas = 0.0;
+        double dual_infeas = 0.0;
+        double gap = 0.0;
+        int iterations = 0;
+        InteriorPointLP::Status status = InteriorPointLP::Status::IterationLimit;
+        double lower_bound = -std::numeric_limits<double>::infinity();
+        double upper_bound = std::numeric_limits<double>::infinity();
+    };
+
+    static void solve(const MatrixA& A, const VectorM& b, const VectorN& c,
+                      const InteriorPointLP::Parameters& params, Solution& sol)
+    {
+        typedef PredictorCorrector<Backend> Iteration;
+
+        const int m = A.rows();
+        const int n = A.cols();
+        const double b_norm = b.norm();
+        const double c_norm = c.norm();
+
+        Backend backend(A, b, c, params.regularization);
+        Iteration::initialPoint(c, m, sol.x, sol.lambda, sol.s);
+
+        VectorM rb(m);
+        VectorN rc(n);
+        typename Iteration::Outcome outcome = Iteration::run(
+            backend, params, sol.x, sol.lambda, sol.s, rb, rc, b_norm, c_norm, params.time_budget);
+        Iteration::useAnytimePoint(backend, outcome, sol.x, sol.lambda, sol.s, rb, rc);
+
+        sol.status = outcome.status;
+        sol.success = outcome.status == InteriorPointLP::Status::Optimal;
+        sol.iterations = outcome.iterations;
+        sol.lower_bound = outcome.bounds.lower;
+        sol.upper_bound = outcome.bounds.upper;
+        sol.optimal_value = c.dot(sol.x);
+        sol.primal_infeas = rb.norm() / (1.0 + b_norm);
+        sol.dual_infeas = rc.norm() / (1.0 + c_norm);
+        sol.gap = sol.x.dot(sol.s) / n;
+    }
+
+private:
+    // PredictorCorrector backend: A D A^T is formed and factored as a fixed-size matrix
+    struct Backend {
+        typedef typename TinyLP::VectorM VectorM;
+        typedef typename TinyLP::VectorN VectorN;
+
+        Backend(const MatrixA& A_, const VectorM& b_, const VectorN& c_, double regularization_)
+            : A(A_), rhs(b_), cost(c_), regularization(regularization_) {}
+
+        const VectorM& b() const { return rhs; }
+        const VectorN& c() const { return cost; }
+
+        void multiply(const VectorN& v, VectorM& out) { out.noalias() = A * v; }
+        void multiplyTranspose(const VectorM& y, VectorN& out) { out.noalias() = A.transpose() * y; }
+
+        void residuals(const VectorN& x, const VectorM& lambda, const VectorN& s, const VectorN*,
+                       VectorM& rb, VectorN& rc)
+        {
+            rb.noalias() = A * x;
+            rb -= rhs;
+            rc.noalias() = A.transpose() * lambda;
+            rc += s - cost;
+        }
+
+        bool factor(const VectorN& d) {
+            MatrixM normal = A * d.asDiagonal() * A.transpose();
+            for (int i = 0; i < normal.rows(); i++) {
+                normal(i, i) += regularization * (1.0 + normal(i, i));
+            }
+            ldlt.compute(normal);
+            return ldlt.info() == Eigen::Success;
+        }
+
+        bool solve(const VectorM& r, VectorM& y) {
+            y = ldlt.solve(r);
+            return y.allFinite();
+        }
+
+        // The kernels do not scale
+        double unscaledNorm(const VectorM& r) const { return r.norm(); }
+
+        const MatrixA& A;
+        const VectorM& rhs;
+        const VectorN& cost;
+        double regularization;
+        Eigen::LDLT<MatrixM> ldlt;
+    };
+};
+
+/**
+ * Solve with a TinyLP kernel if the problem size is at most
+ * TINY_LP_MAX_ROWS x TINY_LP_MAX_COLS (and has no more rows than columns).
+ * Sizes listed in TINY_LP_FIXED_SIZES use their exact fixed-size kernel.
+ * @param A The constraint matrix
+ * @param b The right-hand side vector
+ * @param c The objective coefficient vector
+ * @param params Solver parameters
+ * @param result Filled in if a kernel was used
+ * @return True if a kernel handled the problem
+ */
+bool solveTinyLP(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, const Eigen::VectorXd& c,
+                 const InteriorPointLP::Parameters& params, InteriorPointLP::Result& result);
+
+#endif // TINY_LP_H
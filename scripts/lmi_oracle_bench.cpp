@@ -0,0 +1,124 @@
+#include "lmi_line_oracle.h"
+#include <Eigen/Dense>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Hit-and-run steps per second of LmiLineOracle against a from-scratch
+// boundary oracle that does what volesti's BRDHRWalk does on every step:
+// evaluate A(x) = A0 + sum x_i A_i and B(v) = sum v_i A_i, then solve the
+// generalized symmetric eigenproblem B w = mu (-A(x)) w. Both walks use the
+// same random numbers, so they follow the same trajectory.
+
+typedef Eigen::MatrixXd MT;
+typedef Eigen::VectorXd VT;
+typedef std::chrono::steady_clock Clock;
+
+// A0 = -I and d random symmetric A_i with the given fraction of nonzeros
+std::vector<MT> randomLMI(int m, int d, double density, std::mt19937& gen) {
+    std::normal_distribution<double> normal;
+    std::uniform_real_distribution<double> uniform;
+    std::vector<MT> matrices(d + 1);
+    matrices[0] = -MT::Identity(m, m);
+    for (int i = 1; i <= d; i++) {
+        MT Ai = MT::Zero(m, m);
+        for (int c = 0; c < m; c++) {
+            for (int r = c; r < m; r++) {
+                if (uniform(gen) < density) {
+                    Ai(r, c) = Ai(c, r) = normal(gen);
+                }
+            }
+        }
+        matrices[i] = Ai / std::sqrt(double(m) * d);
+    }
+    return matrices;
+}
+
+class ReferenceOracle {
+public:
+    explicit ReferenceOracle(const std::vector<MT>& matrices_) : matrices(matrices_) {}
+
+    std::pair<double, double> lineIntersect(const VT& x, const VT& v) {
+        const int m = matrices[0].rows();
+        MT A = matrices[0];
+        MT B = MT::Zero(m, m);
+        for (std::size_t i = 1; i < matrices.size(); i++) {
+            A += x(i - 1) * matrices[i];
+            B += v(i - 1) * matrices[i];
+        }
+        solver.compute(B, -A, Eigen::EigenvaluesOnly);
+        const double mu_max = solver.eigenvalues()(m - 1);
+        const double mu_min = solver.eigenvalues()(0);
+        const double inf = std::numeric_limits<double>::infinity();
+        return std::make_pair(mu_max > 0 ? 1.0 / mu_max : inf, mu_min < 0 ? 1.0 / mu_min : -inf);
+    }
+
+private:
+    std::vector<MT> matrices;
+    Eigen::GeneralizedSelfAdjointEigenSolver<MT> solver;
+};
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <m> <d> <density> [steps]" << std::endl;
+        return 1;
+    }
+    const int m = std::atoi(argv[1]);
+    const int d = std::atoi(argv[2]);
+    const double density = std::atof(argv[3]);
+    const int steps = argc > 4 ? std::atoi(argv[4]) : 1000;
+
+    std::mt19937 gen(7);
+    std::vector<MT> matrices = randomLMI(m, d, density, gen);
+
+    // Random directions and step fractions shared by both walks
+    std::normal_distribution<double> normal;
+    std::uniform_real_distribution<double> uniform;
+    std::vector<VT> directions(steps);
+    std::vector<double> fractions(steps);
+    for (int k = 0; k < steps; k++) {
+        directions[k] = VT(d);
+        for (int i = 0; i < d; i++) {
+            directions[k](i) = normal(gen);
+        }
+        directions[k].normalize();
+        fractions[k] = uniform(gen);
+    }
+
+    std::vector<double> chord_reference(steps), chord_cached(steps);
+
+    Clock::time_point start = Clock::now();
+    ReferenceOracle reference(matrices);
+    VT x = VT::Zero(d);
+    for (int k = 0; k < steps; k++) {
+        std::pair<double, double> t = reference.lineIntersect(x, directions[k]);
+        chord_reference[k] = t.first - t.second;
+        x += (t.second + fractions[k] * (t.first - t.second)) * directions[k];
+    }
+    double reference_time = std::chrono::duration<double>(Clock::now() - start).count();
+
+    start = Clock::now();
+    LmiLineOracle<double> oracle(matrices);
+    oracle.setPoint(VT::Zero(d));
+    for (int k = 0; k < steps; k++) {
+        std::pair<double, double> t = oracle.lineIntersect(directions[k]);
+        chord_cached[k] = t.first - t.second;
+        oracle.move(t.second + fractions[k] * (t.first - t.second));
+    }
+    double cached_time = std::chrono::duration<double>(Clock::now() - start).count();
+
+    double max_difference = 0;
+    for (int k = 0; k < steps; k++) {
+        max_difference = std::max(max_difference,
+                                  std::abs(chord_cached[k] - chord_reference[k]) / chord_reference[k]);
+    }
+
+    std::cout << "m=" << m << " d=" << d << " density=" << density << " steps=" << steps
+              << " reference=" << steps / reference_time << " steps/s"
+              << " cached=" << steps / cached_time << " steps/s"
+              << " speedup=" << reference_time / cached_time
+              << " max_chord_rel_diff=" << max_difference << std::endl;
+    return 0;
+}
@@ -0,0 +1,373 @@
+#include "interior_point_lp.h"
+#include "lp_solve_cache.h"
+#include "lp_utils.h"
+#include "out_of_core_lp.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+typedef std::chrono::steady_clock Clock;
+
+// Columns per block of the files written for --out-of-core
+const Eigen::Index OUT_OF_CORE_BLOCK_COLS = 256;
+
+// One LP file as handed from the reader to the solver threads
+struct LoadedProblem {
+    std::string path;
+    size_t index = 0;   // Position in the batch
+    Eigen::MatrixXd A;
+    Eigen::VectorXd b, c;
+    double read_time = 0.0;
+    std::string error;  // Non-empty if the file could not be read
+};
+
+// Bounded FIFO between the reader and the solver threads. The reader blocks
+// once capacity problems are waiting, which bounds memory while still
+// keeping the next files loaded before a solver asks for them.
+class ProblemQueue {
+public:
+    explicit ProblemQueue(size_t capacity_) : capacity(capacity_), closed(false) {}
+
+    void push(LoadedProblem problem) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [this] { return items.size() < capacity; });
+        items.push_back(std::move(problem));
+        not_empty.notify_one();
+    }
+
+    // Returns false once the queue is closed and drained
+    bool pop(LoadedProblem& problem) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [this] { return !items.empty() || closed; });
+        if (items.empty()) {
+            return false;
+        }
+        problem = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        not_empty.notify_all();
+    }
+
+private:
+    size_t capacity;
+    bool closed;
+    std::deque<LoadedProblem> items;
+    std::mutex mutex;
+    std::condition_variable not_empty, not_full;
+};
+
+// Collect the LP files to solve: every regular file in a directory (sorted),
+// or one path per line of a manifest file (relative paths are taken relative
+// to the manifest, blank lines and lines starting with '#' are skipped)
+std::vector<std::string> collectInputs(const std::string& input) {
+    std::vector<std::string> files;
+    if (fs::is_directory(input)) {
+        for (const fs::directory_entry& entry : fs::directory_iterator(input)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+                files.push_back(entry.path().string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    std::ifstream manifest(input);
+    if (!manifest.is_open()) {
+        throw std::runtime_error("Failed to open input: " + input);
+    }
+    fs::path base = fs::path(input).parent_path();
+    std::string line;
+    while (std::getline(manifest, line)) {
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        fs::path path(line);
+        files.push_back(path.is_absolute() ? path.string() : (base / path).string());
+    }
+    return files;
+}
+
+std::string jsonString(const std::string& value) {
+    std::string out = "\"";
+    for (char ch : value) {
+        switch (ch) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            case '\r': out += "\\r"; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", ch);
+                    out += buf;
+                } else {
+                    out += ch;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+std::string jsonNumber(double value) {
+    if (!std::isfinite(value)) {
+        return "null";
+    }
+    std::ostringstream oss;
+    oss.precision(17);
+    oss << value;
+    return oss.str();
+}
+
+// Record status of a finished solve
+const char* statusName(InteriorPointLP::Status status) {
+    switch (status) {
+        case InteriorPointLP::Status::Optimal: return "optimal";
+        case InteriorPointLP::Status::GapReached: return "gap_reached";
+        case InteriorPointLP::Status::TimeLimit: return "time_limit";
+        case InteriorPointLP::Status::IterationLimit:
+        case InteriorPointLP::Status::Breakdown: break;
+    }
+    return "not_converged";
+}
+
+// Solve A from a column block file written to block_dir (OutOfCoreLP), as
+// for a problem whose A is produced on disk; the file is removed afterwards
+InteriorPointLP::Result solveOutOfCore(const LoadedProblem& problem, const std::string& block_dir) {
+    std::string filename = (fs::path(block_dir) / ("problem_" + std::to_string(problem.index) + ".lpcb")).string();
+    ColumnBlockMatrix::write(filename, problem.A, OUT_OF_CORE_BLOCK_COLS);
+    try {
+        InteriorPointLP::Result result = OutOfCoreLP::solve(ColumnBlockMatrix(filename), problem.b, problem.c);
+        fs::remove(filename);
+        return result;
+    } catch (...) {
+        fs::remove(filename);
+        throw;
+    }
+}
+
+// Solve one loaded problem (through cache if given, or out of core from
+// block_dir if that is non-empty) and format its JSON Lines record
+std::string solveProblem(const LoadedProblem& problem, LPSolveCache* cache, const std::string& block_dir) {
+    std::ostringstream record;
+    record << "{\"file\":" << jsonString(problem.path);
+
+    if (!problem.error.empty()) {
+        record << ",\"status\":\"read_error\",\"error\":" << jsonString(problem.error)
+               << ",\"read_ms\":" << jsonNumber(1e3 * problem.read_time) << "}";
+        return record.str();
+    }
+
+    record << ",\"constraints\":" << problem.A.rows() << ",\"variables\":" << problem.A.cols();
+    try {
+        Clock::time_point start = Clock::now();
+        LPSolveCache::Source source = LPSolveCache::Source::Solved;
+        InteriorPointLP::Result result = cache ? cache->solve(problem.A, problem.b, problem.c, &source)
+                                       : !block_dir.empty() ? solveOutOfCore(problem, block_dir)
+                                       : InteriorPointLP::solve(problem.A, problem.b, problem.c);
+        double solve_time = std::chrono::duration<double>(Clock::now() - start).count();
+
+        record << ",\"status\":\"" << statusName(result.status) << "\"";
+        if (cache) {
+            record << ",\"cache\":\"" << (source == LPSolveCache::Source::Cached ? "hit"
+                                         : source == LPSolveCache::Source::WarmStarted ? "warm" : "miss") << "\"";
+        }
+        record << ",\"objective\":" << jsonNumber(result.optimal_value)
+               << ",\"primal_infeas\":" << jsonNumber(result.primal_infeas)
+               << ",\"dual_infeas\":" << jsonNumber(result.dual_infeas)
+               << ",\"gap\":" << jsonNumber(result.gap)
+               << ",\"lower_bound\":" << jsonNumber(result.lower_bound)
+               << ",\"upper_bound\":" << jsonNumber(result.upper_bound)
+               << ",\"iterations\":" << result.iterations
+               << ",\"read_ms\":" << jsonNumber(1e3 * problem.read_time)
+               << ",\"setup_ms\":" << jsonNumber(1e3 * result.setup_time)
+               << ",\"iteration_ms\":" << jsonNumber(1e3 * result.iteration_time)
+               << ",\"solve_ms\":" << jsonNumber(1e3 * solve_time) << "}";
+    } catch (const std::exception& ex) {
+        record << ",\"status\":\"error\",\"error\":" << jsonString(ex.what()) << "}";
+    }
+    return record.str();
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " <directory|manifest> [--output results.jsonl] [--threads N]"
+              << " [--cache MB] [--cache-dir DIR] [--time-budget MS] [--gap G]"
+              << " [--tol T] [--eta E] [--max-iter N] [--regularization R] [--scaling]"
+              << " [--out-of-core DIR]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string input = argv[1];
+    std::string output_filename;
+    unsigned int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    long cache_mb = 0;
+    std::string cache_dir;
+    double time_budget_ms = 0.0;
+    double gap_target = 0.0;
+    std::string block_dir;
+
+    // Same defaults as test3_main, so a batch record matches a single run of
+    // the same file; solver output is per record, not on stdout
+    InteriorPointLP::Parameters params;
+    params.tol = 1e-5;
+    params.eta = 0.8;
+    params.max_iter = 20000;
+    params.regularization = 1e-6;
+    params.use_scaling = false;
+    params.verbose = false;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--output" && i + 1 < argc) {
+            output_filename = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            num_threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--cache" && i + 1 < argc) {
+            cache_mb = std::max(0L, std::atol(argv[++i]));
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            cache_dir = argv[++i];
+        } else if (arg == "--time-budget" && i + 1 < argc) {
+            time_budget_ms = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--gap" && i + 1 < argc) {
+            gap_target = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--tol" && i + 1 < argc) {
+            params.tol = std::atof(argv[++i]);
+        } else if (arg == "--eta" && i + 1 < argc) {
+            params.eta = std::atof(argv[++i]);
+        } else if (arg == "--max-iter" && i + 1 < argc) {
+            params.max_iter = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--regularization" && i + 1 < argc) {
+            params.regularization = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--out-of-core" && i + 1 < argc) {
+            block_dir = argv[++i];
+        } else if (arg == "--scaling") {
+            params.use_scaling = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!(params.tol > 0) || !(params.eta > 0 && params.eta <= 1)) {
+        std::cerr << "Error: --tol must be positive and --eta in (0, 1]" << std::endl;
+        return 1;
+    }
+
+    if (!block_dir.empty() && (cache_mb > 0 || !cache_dir.empty())) {
+        std::cerr << "Error: --out-of-core cannot be combined with --cache or --cache-dir" << std::endl;
+        return 1;
+    }
+    if (!block_dir.empty()) {
+        std::error_code ec;
+        fs::create_directories(block_dir, ec);
+        if (ec) {
+            std::cerr << "Error: cannot create directory " << block_dir << ": " << ec.message() << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::string> files;
+    try {
+        files = collectInputs(input);
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    std::ofstream output_file;
+    if (!output_filename.empty()) {
+        output_file.open(output_filename);
+        if (!output_file.is_open()) {
+            std::cerr << "Error: cannot open file " << output_filename << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = output_filename.empty() ? std::cout : output_file;
+
+    params.time_budget = 1e-3 * time_budget_ms;
+    params.gap_target = gap_target;
+    InteriorPointLP::setParameters(params);
+
+    // Repeated problems in the batch are answered from the cache, and problems
+    // that share A and b are warm started
+    std::unique_ptr<LPSolveCache> cache;
+    if (cache_mb > 0 || !cache_dir.empty()) {
+        cache.reset(new LPSolveCache(std::size_t(cache_mb > 0 ? cache_mb : 256) << 20, cache_dir));
+    }
+
+    ProblemQueue queue(2 * num_threads);
+
+    std::thread reader([&]() {
+        for (size_t i = 0; i < files.size(); i++) {
+            LoadedProblem problem;
+            problem.path = files[i];
+            problem.index = i;
+            Clock::time_point start = Clock::now();
+            try {
+                int numVars = 0, numConstraints = 0;
+                LPUtils::readLPData(problem.path, problem.A, problem.b, problem.c, numVars, numConstraints);
+            } catch (const std::exception& ex) {
+                problem.error = ex.what();
+            }
+            problem.read_time = std::chrono::duration<double>(Clock::now() - start).count();
+            queue.push(std::move(problem));
+        }
+        queue.close();
+    });
+
+    std::mutex out_mutex;
+    std::vector<std::thread> solvers;
+    for (unsigned int t = 0; t < num_threads; t++) {
+        solvers.emplace_back([&]() {
+            LoadedProblem problem;
+            while (queue.pop(problem)) {
+                std::string record = solveProblem(problem, cache.get(), block_dir);
+                std::lock_guard<std::mutex> lock(out_mutex);
+                out << record << '\n';
+            }
+        });
+    }
+
+    reader.join();
+    for (std::thread& solver : solvers) {
+        solver.join();
+    }
+    out.flush();
+
+    if (cache) {
+        LPSolveCache::Stats stats = cache->stats();
+        std::cerr << "Cache: " << stats.exact_hits << " hits, " << stats.disk_hits << " disk hits, "
+                  << stats.warm_starts << " warm starts, " << stats.misses << " misses (hit rate "
+                  << stats.hitRate() << "), " << stats.evictions << " evictions" << std::endl;
+    }
+
+    return 0;
+}
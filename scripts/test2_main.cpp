@@ -8,14 +8,21 @@
 
 
 // Edited by HZ on 11.06.2020 - mute doctest.h
+#include <algorithm>
+#include <cstdlib>
+#include <atomic>
+#include <exception>
 #include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <boost/random.hpp>
 
 #include "random_walks/random_walks.hpp"
 #include "sampling/sampling.hpp"
-#include "diagnostics/univariate_psrf.hpp"
 
 // Add the spectrahedron headers
 #include "convex_bodies/spectrahedra/spectrahedron.h"
@@ -24,66 +31,239 @@
 // Add this include after the other spectrahedron headers
 #include "convex_bodies/spectrahedra/const_spectrahedron_wrapper.h"
 
-// Add necessary namespaces
+#include "sample_sink.h"
+#include "online_diagnostics.h"
+#include "cached_boundary_rdhr_walk.h"
+
+// Point container that writes each sample straight into a fixed range of
+// columns of a preallocated matrix. It exposes the push_back/clear interface
+// that uniform_sampling_boundary expects from its point list, so no list
+// nodes are allocated in the sampling loop.
+template <typename MT, typename Point>
+struct MatrixColumnWriter {
+    MT &samples;
+    Eigen::Index begin;
+    Eigen::Index end;
+    Eigen::Index next;
+
+    MatrixColumnWriter(MT &samples_, Eigen::Index begin_, Eigen::Index end_)
+        : samples(samples_), begin(begin_), end(end_), next(begin_) {}
+
+    void push_back(const Point &p) {
+        if (next < end) {
+            samples.col(next++) = p.getCoefficients();
+        }
+    }
+
+    // Called by uniform_sampling_boundary to drop the burn-in points
+    void clear() { next = begin; }
+
+    Eigen::Index size() const { return next - begin; }
+};
+
+// Run num_chains independent boundary chains, one per thread. Chain k uses
+// its own copy of the spectrahedron (the oracle caches per-line values) and
+// its own RNG seeded with base_seed + k, and fills columns
+// [k * points_per_chain, (k + 1) * points_per_chain) of the result.
 template
 <
     typename MT,
     typename WalkType,
     typename SpectrahedronType
 >
-MT get_samples_boundary_spectahedron(SpectrahedronType &S)
+MT get_samples_boundary_spectahedron_parallel(const SpectrahedronType &S,
+                                              unsigned int num_chains,
+                                              unsigned int points_per_chain,
+                                              unsigned int walkL = 10,
+                                              unsigned int nburns = 0,
+                                              unsigned int base_seed = 3)
 {
     typedef typename SpectrahedronType::PointType Point;
     typedef typename SpectrahedronType::NT NT;
-    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT> RNGType;
 
-    unsigned int walkL = 10, numpoints = 10000, nburns = 0, d = S.dimension();
-    RNGType rng(d);
-    Point StartingPoint(d);
-    std::list<Point> randPoints;
+    if (num_chains == 0) {
+        throw std::invalid_argument("Number of chains must be positive");
+    }
+    // The boundary walk emits two points per step
+    if (points_per_chain % 2 != 0) {
+        points_per_chain++;
+    }
+
+    const unsigned int d = S.dimension();
+    MT samples(d, Eigen::Index(num_chains) * points_per_chain);
+
+    std::cout << "Starting uniform sampling on the boundary of the spectrahedron with "
+              << num_chains << " chains of " << points_per_chain << " points." << std::endl;
 
-    std::cout << "Starting uniform sampling on the boundary of the spectrahedron." << std::endl;
-    uniform_sampling_boundary<WalkType>(randPoints, S, rng, walkL, numpoints,
-                                        StartingPoint, nburns);
-    std::cout << "Finished sampling. Number of points: " << randPoints.size() << std::endl;
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(num_chains);
+    workers.reserve(num_chains);
+
+    for (unsigned int k = 0; k < num_chains; k++) {
+        workers.emplace_back([&, k]() {
+            try {
+                SpectrahedronType S_chain = S;
+                RNGType rng(d);
+                rng.set_seed(base_seed + k);
+                Point StartingPoint(d);
+
+                Eigen::Index first = Eigen::Index(k) * points_per_chain;
+                MatrixColumnWriter<MT, Point> writer(samples, first, first + points_per_chain);
+                uniform_sampling_boundary<WalkType>(writer, S_chain, rng, walkL,
+                                                    points_per_chain, StartingPoint, nburns);
+            } catch (...) {
+                errors[k] = std::current_exception();
+            }
+        });
+    }
 
-    MT samples(d, numpoints);
-    unsigned int jj = 0;
-    for (typename std::list<Point>::iterator rpit = randPoints.begin(); rpit != randPoints.end(); rpit++, jj++)
-    {
-        samples.col(jj) = (*rpit).getCoefficients();
+    for (std::thread &worker : workers) {
+        worker.join();
     }
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::cout << "Finished sampling. Number of points: " << samples.cols() << std::endl;
     return samples;
 }
 
-// New helper function to write samples to an Excel-compatible CSV file
-template<typename MT>
-void write_samples_to_excel(const MT &samples, const std::string &filename) {
-    std::ofstream out(filename);
-    if(!out) {
-        std::cerr << "Error: cannot open file " << filename << std::endl;
-        return;
-    }
-    for(int i = 0; i < samples.rows(); ++i) {
-        for(int j = 0; j < samples.cols(); ++j) {
-            out << samples(i, j) << (j < samples.cols()-1 ? "," : "");
+// Adaptive streaming sampler: chains run until the combined diagnostics
+// meet the target (checked every check_every points per chain, once every
+// chain has published min_points_per_chain) or until max_points_per_chain
+// is reached.
+// Every sample updates its chain's running statistics in O(d); the chain
+// publishes them to the shared monitor at each check.
+template
+<
+    typename MT,
+    typename WalkType,
+    typename SpectrahedronType
+>
+void sample_boundary_spectahedron_until_converged(const SpectrahedronType &S,
+                                                  SampleSink<MT> &sink,
+                                                  MultiChainMonitor<typename SpectrahedronType::NT> &monitor,
+                                                  const ConvergenceTarget &target,
+                                                  unsigned int num_chains,
+                                                  unsigned int min_points_per_chain,
+                                                  unsigned int max_points_per_chain,
+                                                  unsigned int check_every = 1024,
+                                                  unsigned int block_size = 1024,
+                                                  unsigned int walkL = 10,
+                                                  unsigned int nburns = 0,
+                                                  unsigned int base_seed = 3)
+{
+    typedef typename SpectrahedronType::PointType Point;
+    typedef typename SpectrahedronType::NT NT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT> RNGType;
+    typedef typename WalkType::template Walk<SpectrahedronType, RNGType> Walk;
+
+    if (num_chains == 0 || block_size == 0 || check_every == 0) {
+        throw std::invalid_argument("Number of chains, block size and check interval must be positive");
+    }
+
+    const unsigned int d = S.dimension();
+    std::atomic<bool> stop(false);
+
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(num_chains);
+    workers.reserve(num_chains);
+
+    for (unsigned int k = 0; k < num_chains; k++) {
+        workers.emplace_back([&, k]() {
+            try {
+                SpectrahedronType S_chain = S;
+                RNGType rng(d);
+                rng.set_seed(base_seed + k);
+                Point p(d), p1(d), p2(d);
+
+                Walk walk(S_chain, p, rng);
+                for (unsigned int i = 0; i < nburns; i++) {
+                    walk.apply(S_chain, p1, p2, walkL, rng);
+                }
+
+                OnlineChainStats<NT> stats(d);
+                BlockedSinkWriter<MT, Point> writer(sink, k, d, block_size);
+                unsigned int produced = 0, next_check = check_every;
+
+                while (produced < max_points_per_chain && !stop.load(std::memory_order_relaxed)) {
+                    walk.apply(S_chain, p1, p2, walkL, rng);
+                    stats.update(p1.getCoefficients());
+                    stats.update(p2.getCoefficients());
+                    writer.push_back(p1);
+                    writer.push_back(p2);
+                    produced += 2;
+
+                    if (produced >= next_check) {
+                        next_check += check_every;
+                        monitor.publish(k, stats);
+                        if (monitor.minCount() >= min_points_per_chain && monitor.converged(target)) {
+                            stop.store(true, std::memory_order_relaxed);
+                        }
+                    }
+                }
+                monitor.publish(k, stats);
+                writer.finish();
+            } catch (...) {
+                errors[k] = std::current_exception();
+                stop.store(true, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// Smallest LMI size m for which CachedBRDHRWalk replaces BRDHRWalk.
+// scripts/lmi_oracle_bench measures no gain from the cached oracle below
+// about m = 20 (0.94x to 1.02x at m = 8) and a clear one from m = 50 on.
+const Eigen::Index CACHED_WALK_MIN_LMI_SIZE = 50;
+
+// Diagnose fixed-size chains sampled by get_samples_boundary_spectahedron_parallel
+// (chain k in columns [k * points_per_chain, (k + 1) * points_per_chain)) and
+// write them to the sink, chain by chain
+template <typename MT, typename NT>
+void publish_fixed_chains(const MT &samples, unsigned int num_chains, SampleSink<MT> &sink,
+                          MultiChainMonitor<NT> &monitor)
+{
+    const Eigen::Index points_per_chain = samples.cols() / num_chains;
+    for (unsigned int k = 0; k < num_chains; k++) {
+        const Eigen::Index first = Eigen::Index(k) * points_per_chain;
+        OnlineChainStats<NT> stats(samples.rows());
+        for (Eigen::Index j = first; j < first + points_per_chain; j++) {
+            stats.update(samples.col(j));
         }
-        out << "\n";
+        monitor.publish(k, stats);
+        sink.write_block(k, samples.middleCols(first, points_per_chain), points_per_chain);
     }
-    out.close();
-    std::cout << "Written samples to " << filename << std::endl;
+    sink.flush();
 }
 
-template <typename NT, typename WalkType = BRDHRWalk>
-void sample_spectrahedron_boundary(){
+// Sample the boundary of the spectrahedron in filepath and write the points
+// to csv_filename and binary_filename. With points_per_chain = 0 the chains
+// run until the PSRF and ESS target is met; otherwise each chain draws
+// exactly points_per_chain points.
+template <typename NT>
+void sample_spectrahedron_boundary(const std::string &filepath,
+                                   const std::string &csv_filename,
+                                   const std::string &binary_filename,
+                                   unsigned int points_per_chain = 0){
     typedef Cartesian<NT>    Kernel;
     typedef typename Kernel::Point    Point;
     typedef ConstSpectrahedronWrapper<Point>  SpectrahedronType;
     typedef Eigen::Matrix<NT,Eigen::Dynamic,Eigen::Dynamic> MT;
     typedef Eigen::Matrix<NT,Eigen::Dynamic,1> VT;
     
-    std::string filepath = "/home/syauqirp/gsoc25/tp_library/volesti/test/SDP/sdp__2_8.txt";
-
     SpectrahedronType S;
 
     SdpaFormatManager<NT> sdpaManager;
@@ -107,15 +287,43 @@ void sample_spectrahedron_boundary(){
     Point initialPoint(S.getLMI().dimension());
     S.set_interior_point(initialPoint);
     
-    std::cout << "Starting boundary sampling." << std::endl;
-    MT samples = get_samples_boundary_spectahedron<MT, WalkType, SpectrahedronType>(S);
-    std::cout << "Boundary sampling completed." << std::endl;
+    unsigned int num_chains = std::max(2u, std::thread::hardware_concurrency());
 
-    // Write the samples to an Excel-compatible CSV file
-    write_samples_to_excel(samples, "/home/syauqirp/gsoc25/samples_output.csv");
+    // Without a fixed chain length, sample until every coordinate has
+    // PSRF < 1.1 and an ESS of at least 1000, with at least 1000 and at most
+    // 10^6 points per chain
+    ConvergenceTarget target;
+    target.max_psrf = 1.1;
+    target.min_ess = 1000;
+    MultiChainMonitor<NT> monitor(num_chains, dim);
+
+    // Stream the samples as CSV (one point per line) and in compact binary form
+    CsvSampleSink<MT> csv_sink(csv_filename, dim);
+    BinarySampleSink<MT> binary_sink(binary_filename, dim);
+    TeeSampleSink<MT> sink(csv_sink, binary_sink);
+
+    const Eigen::Index lmi_size = S.getLMI().getMatrices()[0].rows();
+    const bool cached_walk = lmi_size >= CACHED_WALK_MIN_LMI_SIZE;
+    std::cout << "Starting boundary sampling with " << num_chains << " chains ("
+              << (cached_walk ? "CachedBRDHRWalk" : "BRDHRWalk") << ", LMI size " << lmi_size << ")." << std::endl;
+    if (points_per_chain > 0) {
+        MT samples = cached_walk
+            ? get_samples_boundary_spectahedron_parallel<MT, CachedBRDHRWalk>(S, num_chains, points_per_chain)
+            : get_samples_boundary_spectahedron_parallel<MT, BRDHRWalk>(S, num_chains, points_per_chain);
+        publish_fixed_chains(samples, num_chains, sink, monitor);
+    } else if (cached_walk) {
+        sample_boundary_spectahedron_until_converged<MT, CachedBRDHRWalk, SpectrahedronType>(
+            S, sink, monitor, target, num_chains, 1000, 1000000);
+    } else {
+        sample_boundary_spectahedron_until_converged<MT, BRDHRWalk, SpectrahedronType>(
+            S, sink, monitor, target, num_chains, 1000, 1000000);
+    }
+    std::cout << "Boundary sampling completed." << std::endl;
+    std::cout << "Written samples to " << csv_filename << " and " << binary_filename << std::endl;
 
-    VT score = univariate_psrf<NT, VT>(samples);
+    VT score = monitor.psrf();
     std::cout << "PSRF score: " << score.maxCoeff() << std::endl;
+    std::cout << "Minimum ESS: " << monitor.ess().minCoeff() << std::endl;
 
     if(score.maxCoeff() < 1.1) {
         std::cout << "PSRF test passed: score is below 1.1" << std::endl;
@@ -124,10 +332,25 @@ void sample_spectrahedron_boundary(){
     }
 }
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <sdpa file> [samples.csv] [samples.bin] [points per chain]"
+                  << std::endl;
+        return 1;
+    }
+    std::string sdpa_filename = argv[1];
+    std::string csv_filename = argc > 2 ? argv[2] : "samples_output.csv";
+    std::string binary_filename = argc > 3 ? argv[3] : "samples_output.bin";
+    long points_per_chain = argc > 4 ? std::atol(argv[4]) : 0;
+    if (points_per_chain < 0) {
+        std::cerr << "Error: points per chain must be nonnegative" << std::endl;
+        return 1;
+    }
+
     std::cout << "Starting spectrahedron boundary sampling program" << std::endl;
     try {
-        sample_spectrahedron_boundary<double, BRDHRWalk>();
+        sample_spectrahedron_boundary<double>(sdpa_filename, csv_filename, binary_filename,
+                                              static_cast<unsigned int>(points_per_chain));
         std::cout << "Program completed successfully" << std::endl;
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
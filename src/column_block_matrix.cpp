@@ -0,0 +1,189 @@
+#include "column_block_matrix.h"
+#include <algorithm>
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char MAGIC[4] = {'L', 'P', 'C', 'B'};
+const std::uint32_t VERSION = 1;
+
+struct Header {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t rows;
+    std::uint64_t cols;
+    std::uint64_t block_cols;
+};
+
+} // namespace
+
+ColumnBlockMatrix::ColumnBlockMatrix(const std::string& filename)
+    : fd(-1), mapping(nullptr), mapping_size(0), data(nullptr),
+      num_rows(0), num_cols(0), block_cols(1), num_blocks(0)
+{
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + filename + " (" + std::strerror(errno) + ")");
+    }
+
+    struct stat st;
+    Header header;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))
+        || ::pread(fd, &header, sizeof(Header), 0) != static_cast<ssize_t>(sizeof(Header))
+        || std::memcmp(header.magic, MAGIC, 4) != 0 || header.version != VERSION
+        || header.block_cols == 0) {
+        ::close(fd);
+        throw std::runtime_error("Not a column block file: " + filename);
+    }
+
+    num_rows = header.rows;
+    num_cols = header.cols;
+    block_cols = header.block_cols;
+    num_blocks = (num_cols + block_cols - 1) / block_cols;
+
+    mapping_size = sizeof(Header) + sizeof(double) * std::size_t(num_rows) * std::size_t(num_cols);
+    if (static_cast<std::size_t>(st.st_size) < mapping_size) {
+        ::close(fd);
+        throw std::runtime_error("Column block file is truncated: " + filename);
+    }
+
+    void* ptr = ::mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Failed to map file: " + filename + " (" + std::strerror(errno) + ")");
+    }
+    mapping = static_cast<char*>(ptr);
+    data = reinterpret_cast<const double*>(mapping + sizeof(Header));
+
+    // Blocks are read in order, so the kernel may read ahead aggressively
+    ::madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+}
+
+ColumnBlockMatrix::~ColumnBlockMatrix() {
+    if (mapping) {
+        ::munmap(mapping, mapping_size);
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+Eigen::Index ColumnBlockMatrix::blockSize(Eigen::Index k) const {
+    return std::min(block_cols, num_cols - blockStart(k));
+}
+
+ColumnBlockMatrix::Block ColumnBlockMatrix::block(Eigen::Index k) const {
+    return Block(data + blockStart(k) * num_rows, num_rows, blockSize(k));
+}
+
+void ColumnBlockMatrix::blockRange(Eigen::Index k, char*& begin, std::size_t& length) const {
+    static const std::size_t page = ::sysconf(_SC_PAGESIZE);
+    const char* first = reinterpret_cast<const char*>(data + blockStart(k) * num_rows);
+    const char* last = first + sizeof(double) * std::size_t(num_rows) * std::size_t(blockSize(k));
+
+    std::size_t offset = (first - mapping) / page * page;
+    begin = mapping + offset;
+    length = last - begin;
+}
+
+void ColumnBlockMatrix::prefetch(Eigen::Index k) const {
+    char* begin;
+    std::size_t length;
+    blockRange(k, begin, length);
+    ::madvise(begin, length, MADV_WILLNEED);
+}
+
+void ColumnBlockMatrix::release(Eigen::Index k) const {
+    // Keep the page shared with block k + 1 mapped
+    static const std::size_t page = ::sysconf(_SC_PAGESIZE);
+    char* begin;
+    std::size_t length;
+    blockRange(k, begin, length);
+    length = length / page * page;
+    if (length > 0) {
+        ::madvise(begin, length, MADV_DONTNEED);
+    }
+}
+
+Eigen::VectorXd ColumnBlockMatrix::multiply(const Eigen::VectorXd& x) const {
+    if (x.size() != num_cols) {
+        throw std::invalid_argument("Vector size must match the number of columns");
+    }
+    Eigen::VectorXd y = Eigen::VectorXd::Zero(num_rows);
+    forEachBlock([&](Eigen::Index j0, const Block& A_k) {
+        y.noalias() += A_k * x.segment(j0, A_k.cols());
+    });
+    return y;
+}
+
+Eigen::VectorXd ColumnBlockMatrix::multiplyTranspose(const Eigen::VectorXd& y) const {
+    if (y.size() != num_rows) {
+        throw std::invalid_argument("Vector size must match the number of rows");
+    }
+    Eigen::VectorXd x(num_cols);
+    forEachBlock([&](Eigen::Index j0, const Block& A_k) {
+        x.segment(j0, A_k.cols()).noalias() = A_k.transpose() * y;
+    });
+    return x;
+}
+
+void ColumnBlockMatrix::write(const std::string& filename, const Eigen::MatrixXd& A, Eigen::Index block_cols) {
+    ColumnBlockWriter writer(filename, A.rows(), A.cols(), block_cols);
+    writer.append(A);
+    writer.close();
+}
+
+ColumnBlockWriter::ColumnBlockWriter(const std::string& filename, Eigen::Index rows, Eigen::Index cols,
+                                     Eigen::Index block_cols)
+    : out(filename, std::ios::binary), num_rows(rows), num_cols(cols), written_cols(0)
+{
+    if (!out) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    if (block_cols < 1) {
+        throw std::invalid_argument("Blocks need at least one column");
+    }
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, 4);
+    header.version = VERSION;
+    header.rows = rows;
+    header.cols = cols;
+    header.block_cols = block_cols;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+}
+
+void ColumnBlockWriter::append(const Eigen::Ref<const Eigen::MatrixXd>& columns) {
+    if (columns.rows() != num_rows) {
+        throw std::invalid_argument("Appended columns must have one entry per row");
+    }
+    if (written_cols + columns.cols() > num_cols) {
+        throw std::invalid_argument("More columns appended than announced");
+    }
+
+    if (columns.outerStride() == num_rows) {
+        out.write(reinterpret_cast<const char*>(columns.data()), sizeof(double) * num_rows * columns.cols());
+    } else {
+        for (Eigen::Index j = 0; j < columns.cols(); j++) {
+            out.write(reinterpret_cast<const char*>(columns.col(j).data()), sizeof(double) * num_rows);
+        }
+    }
+    written_cols += columns.cols();
+}
+
+void ColumnBlockWriter::close() {
+    if (written_cols != num_cols) {
+        throw std::runtime_error("Column block file closed before all columns were written");
+    }
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write column block file");
+    }
+}
@@ -0,0 +1,147 @@
+#include "incremental_lp.h"
+#include <algorithm>
+#include <cmath>
+
+// Smallest iteration allowance of a warm start before it falls back to a cold solve
+static const int MIN_WARM_ITERATIONS = 20;
+
+IncrementalLP::IncrementalLP(const Eigen::MatrixXd& A_orig, const Eigen::VectorXd& b_orig, const Eigen::VectorXd& c_orig)
+    : A_buffer(A_orig), m(A_orig.rows()), n(A_orig.cols()), b(b_orig), c(c_orig),
+      b_norm_sq(b_orig.squaredNorm()), c_norm_sq(c_orig.squaredNorm()),
+      warm(false), cold_iterations(0), warm_start_level(1.0), shift_fraction(1e-1)
+{
+    if (A_orig.rows() != b.size()) {
+        throw std::invalid_argument("Matrix A rows must match vector b size");
+    }
+    if (A_orig.cols() != c.size()) {
+        throw std::invalid_argument("Matrix A columns must match vector c size");
+    }
+
+    if (InteriorPointLP::params.use_scaling) {
+        scaling = LPUtils::scaleLP(A_buffer, b, c);
+    }
+}
+
+void IncrementalLP::reserve(Eigen::Index rows, Eigen::Index cols) {
+    if (rows <= A_buffer.rows() && cols <= A_buffer.cols()) {
+        return;
+    }
+
+    // Grow geometrically, so a sequence of appends copies A O(log) times
+    Eigen::MatrixXd grown(std::max(rows, A_buffer.rows() < rows ? 2 * A_buffer.rows() : A_buffer.rows()),
+                          std::max(cols, A_buffer.cols() < cols ? 2 * A_buffer.cols() : A_buffer.cols()));
+    grown.topLeftCorner(m, n) = A_buffer.topLeftCorner(m, n);
+    A_buffer.swap(grown);
+}
+
+void IncrementalLP::addRows(const Eigen::MatrixXd& A_rows, const Eigen::VectorXd& b_rows) {
+    if (A_rows.cols() != n) {
+        throw std::invalid_argument("New rows must have one entry per variable");
+    }
+    if (A_rows.rows() != b_rows.size()) {
+        throw std::invalid_argument("New rows must match the new right-hand side size");
+    }
+
+    const Eigen::Index k = A_rows.rows();
+    b_norm_sq += b_rows.squaredNorm();
+
+    Eigen::MatrixXd A_new = A_rows;
+    Eigen::VectorXd b_new = b_rows;
+    LPUtils::scaleNewRows(A_new, b_new, scaling);
+
+    reserve(m + k, n);
+    A_buffer.block(m, 0, k, n) = A_new;
+    b.conservativeResize(m + k);
+    b.tail(k) = b_new;
+    m += k;
+
+    if (warm) {
+        lambda.conservativeResize(m);
+        lambda.tail(k).setZero();
+    }
+}
+
+void IncrementalLP::addColumns(const Eigen::MatrixXd& A_cols, const Eigen::VectorXd& c_cols) {
+    if (A_cols.rows() != m) {
+        throw std::invalid_argument("New columns must have one entry per constraint");
+    }
+    if (A_cols.cols() != c_cols.size()) {
+        throw std::invalid_argument("New columns must match the new objective size");
+    }
+
+    const Eigen::Index k = A_cols.cols();
+    c_norm_sq += c_cols.squaredNorm();
+
+    Eigen::MatrixXd A_new = A_cols;
+    Eigen::VectorXd c_new = c_cols;
+    LPUtils::scaleNewColumns(A_new, c_new, scaling);
+
+    reserve(m, n + k);
+    A_buffer.block(0, n, m, k) = A_new;
+    c.conservativeResize(n + k);
+    c.tail(k) = c_new;
+    n += k;
+
+    if (warm) {
+        // New variables start at the centrality of the stored point, with
+        // their reduced cost as dual slack where it is large enough
+        const double delta = std::sqrt(x.dot(s) / x.size());
+        x.conservativeResize(n);
+        x.tail(k).setConstant(delta);
+        s.conservativeResize(n);
+        s.tail(k) = (c_new - A_new.transpose() * lambda).cwiseMax(delta);
+    }
+}
+
+InteriorPointLP::Result IncrementalLP::solve() {
+    const InteriorPointLP::Parameters& params = InteriorPointLP::params;
+    const double b_norm = std::sqrt(b_norm_sq);
+    const double c_norm = std::sqrt(c_norm_sq);
+
+    InteriorPointLP::Result result;
+    InteriorPointLP::Snapshot snapshot;
+    snapshot.gap = warm_start_level;
+    snapshot.residual = 1e-1 * warm_start_level;
+    int warm_iterations = 0;
+
+    if (warm) {
+        // Keep the stored point and shift only the pairs that would block the
+        // first steps; give up on it once it takes as long as a cold solve
+        InteriorPointLP::shiftBlockingPairs(x, s, shift_fraction);
+        InteriorPointLP::Parameters warm_params = params;
+        warm_params.max_iter = std::min(params.max_iter, std::max(MIN_WARM_ITERATIONS, cold_iterations));
+
+        result = InteriorPointLP::iterate(warm_params, matrix(), b, c, x, lambda, s, scaling, b_norm, c_norm,
+                                          0.0, &snapshot);
+        // A stop at the time budget or the gap target ends the solve as well
+        if (result.status != InteriorPointLP::Status::IterationLimit &&
+            result.status != InteriorPointLP::Status::Breakdown) {
+            storeWarmStart(snapshot);
+            return result;
+        }
+        warm_iterations = result.iterations;
+        snapshot.taken = false;
+    }
+
+    InteriorPointLP::computeInitialPoint(b, c, x, lambda, s);
+    result = InteriorPointLP::iterate(params, matrix(), b, c, x, lambda, s, scaling, b_norm, c_norm,
+                                      0.0, &snapshot);
+    if (result.success) {
+        cold_iterations = result.iterations;
+    }
+    result.iterations += warm_iterations;
+    storeWarmStart(snapshot);
+    return result;
+}
+
+void IncrementalLP::storeWarmStart(const InteriorPointLP::Snapshot& snapshot) {
+    // The kept iterate if the run got that far, otherwise the final one
+    if (snapshot.taken) {
+        x = snapshot.x;
+        lambda = snapshot.lambda;
+        s = snapshot.s;
+    }
+
+    // A broken iterate is no use as a warm start; the next solve starts cold
+    warm = !LPUtils::containsNanOrInf(x) && !LPUtils::containsNanOrInf(lambda) && !LPUtils::containsNanOrInf(s);
+}
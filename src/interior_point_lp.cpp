@@ -1,13 +1,23 @@
 #include "interior_point_lp.h"
 #include "lp_utils.h"
+#include "predictor_corrector.h"
+#include "tiny_lp.h"
+#include <chrono>
 #include <cmath>
 
 // Initialize static parameters
 InteriorPointLP::Parameters InteriorPointLP::params;
 
+// Largest relative residual of a Sherman-Morrison-Woodbury solve before the
+// split normal equations fall back to the augmented system. Accurate solves
+// of the regularized system end up around 1e-8 late in the iteration (the
+// augmented system does no better there); a failing correction is off by
+// orders of magnitude more.
+static const double SMW_RESIDUAL_TOL = 1e-6;
+
 InteriorPointLP::Result InteriorPointLP::solve(const Eigen::MatrixXd& A_orig, const Eigen::VectorXd& b_orig, const Eigen::VectorXd& c_orig) {
-    Result result;
-    result.success = false;
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point setup_start = Clock::now();
 
     if (A_orig.rows() != b_orig.size()) {
         throw std::invalid_argument("Matrix A rows must match vector b size");
@@ -16,6 +26,22 @@ InteriorPointLP::Result InteriorPointLP::solve(const Eigen::MatrixXd& A_orig, co
         throw std::invalid_argument("Matrix A columns must match vector c size");
     }
 
+    // Very small problems go to a fixed-size kernel
+    if (params.use_tiny_kernels) {
+        Result result;
+        if (solveTinyLP(A_orig, b_orig, c_orig, params, result)) {
+            result.iteration_time = std::chrono::duration<double>(Clock::now() - setup_start).count();
+            if (params.verbose) {
+                std::cout << "Solved LP problem with " << A_orig.cols() << " variables and " << A_orig.rows()
+                          << " constraints in " << result.iterations << " iterations (fixed-size kernel)" << std::endl;
+                std::cout << (result.success ? "Optimal value: " : "Current value: ") << result.optimal_value << std::endl;
+                std::cout << (result.success ? "Optimal solution (x): " : "Current solution (x): ")
+                          << result.x.transpose() << std::endl;
+            }
+            return result;
+        }
+    }
+
     // Create working copies of the inputs
     Eigen::MatrixXd A = A_orig;
     Eigen::VectorXd b = b_orig;
@@ -26,7 +52,9 @@ InteriorPointLP::Result InteriorPointLP::solve(const Eigen::MatrixXd& A_orig, co
     const int m = b.size();  // Number of constraints
     
     // Simple status output
-    std::cout << "Solving LP problem with " << n << " variables and " << m << " constraints" << std::endl;
+    if (params.verbose) {
+        std::cout << "Solving LP problem with " << n << " variables and " << m << " constraints" << std::endl;
+    }
     
     // Scale the problem if needed
     LPUtils::ScalingInfo scaling;
@@ -38,339 +66,411 @@ InteriorPointLP::Result InteriorPointLP::solve(const Eigen::MatrixXd& A_orig, co
     Eigen::VectorXd x(n), lambda(m), s(n);
     
     // Compute initial point
-    computeInitialPoint(A, b, c, x, lambda, s);
-    
-    // Main iteration loop
-    int iter = 0;
-    while (iter < params.max_iter) {
-        // Check for NaN values
-        if (LPUtils::containsNanOrInf(x) || LPUtils::containsNanOrInf(lambda) || LPUtils::containsNanOrInf(s)) {
-            break;
-        }
-        
-        // Current duality measure
-        double mu = x.dot(s) / n;
-        
-        // Compute residuals
-        Eigen::VectorXd rc = A.transpose() * lambda + s - c; // Dual residual
-        Eigen::VectorXd rb = A * x - b;                     // Primal residual
-        
-        // Check convergence
-        if (checkConvergence(x, lambda, s, rc, rb, mu, b_orig, c_orig)) {
-            result.success = true;
-            result.x = x;
-            result.optimal_value = c_orig.dot(x);
-            result.primal_infeas = rb.norm() / (1.0 + b_orig.norm());
-            result.dual_infeas = rc.norm() / (1.0 + c_orig.norm());
-            result.gap = mu;
-
-            std::cout << "Converged after " << iter << " iterations." << std::endl;
-            
-            // Rescale solution if needed
-            if (params.use_scaling) {
-                LPUtils::rescaleSolution(result.x, lambda, s, scaling);
-            }
-            
-            std::cout << "Optimal value: " << result.optimal_value << std::endl;
-            std::cout << "Optimal solution (x): " << result.x.transpose() << std::endl;
-            
-            return result;
-        }
-        
-        // Step 1: Compute affine scaling direction (predictor)
-        Eigen::VectorXd dx_aff(n), dlambda_aff(m), ds_aff(n);
-        computeAffineDirection(A, x, lambda, s, dx_aff, dlambda_aff, ds_aff, rc, rb);
-        
-        // Step 2: Compute step lengths for affine direction
-        double alpha_pri_aff, alpha_dual_aff;
-        computeStepLengths(x, s, dx_aff, ds_aff, alpha_pri_aff, alpha_dual_aff);
-        
-        // Step 3: Compute centering parameter
-        double sigma = computeCenteringParameter(x, s, dx_aff, ds_aff, alpha_pri_aff, alpha_dual_aff, mu);
-        
-        // Step 4: Compute combined direction (corrector)
-        Eigen::VectorXd dx(n), dlambda(m), ds(n);
-        computeCombinedDirection(A, x, lambda, s, dx_aff, ds_aff, dx, dlambda, ds, rc, rb, sigma, mu);
-        
-        // Step 5: Compute step lengths for combined direction
-        double alpha_pri, alpha_dual;
-        computeStepLengths(x, s, dx, ds, alpha_pri, alpha_dual);
-        
-        // Apply step length scaling factor
-        double eta_factor = params.eta;
-        if (n > 1000) {
-            eta_factor = std::min(0.7, eta_factor);
-        }
-        alpha_pri = std::min(1.0, eta_factor * alpha_pri);
-        alpha_dual = std::min(1.0, eta_factor * alpha_dual);
-        
-        // Step 6: Update variables
-        x = x + alpha_pri * dx;
-        lambda = lambda + alpha_dual * dlambda;
-        s = s + alpha_dual * ds;
-        
-        iter++;
+    computeInitialPoint(b, c, x, lambda, s);
+
+    double setup_time = std::chrono::duration<double>(Clock::now() - setup_start).count();
+
+    Result result = iterate(params, A, b, c, x, lambda, s, scaling, b_orig.norm(), c_orig.norm(), setup_time);
+    result.setup_time += setup_time;
+    return result;
+}
+
+// In-memory A with the dense or split normal equations of NormalEquations
+struct InteriorPointLP::DenseBackend {
+    typedef Eigen::VectorXd VectorM;
+    typedef Eigen::VectorXd VectorN;
+
+    DenseBackend(const Eigen::Ref<const Eigen::MatrixXd>& A_, const Eigen::VectorXd& b_, const Eigen::VectorXd& c_,
+                 const LPUtils::ScalingInfo& scaling_, const Parameters& p_)
+        : A(A_), rhs(b_), cost(c_), scaling(scaling_), p(p_)
+    {
+        analyzeNormalEquations(A, p, ne);
     }
-    
-    std::cout << "Maximum iterations reached. Solution may not be optimal." << std::endl;
-    
-    // Rescale solution if needed
-    if (params.use_scaling) {
-        LPUtils::rescaleSolution(x, lambda, s, scaling);
+
+    const VectorM& b() const { return rhs; }
+    const VectorN& c() const { return cost; }
+
+    void multiply(const VectorN& v, VectorM& out) { out.noalias() = A * v; }
+    void multiplyTranspose(const VectorM& y, VectorN& out) { out.noalias() = A.transpose() * y; }
+
+    void residuals(const VectorN& x, const VectorM& lambda, const VectorN& s, const VectorN*,
+                   VectorM& rb, VectorN& rc)
+    {
+        rb = A * x - rhs;
+        rc = A.transpose() * lambda + s - cost;
     }
-    
-    // Recompute final residuals and duality measure
-    Eigen::VectorXd rb = A * x - b;
-    Eigen::VectorXd rc = A.transpose() * lambda + s - c;
-    double mu = x.dot(s) / n;
-    
-    result.x = x;
-    result.optimal_value = c_orig.dot(x);
-    result.primal_infeas = rb.norm() / (1.0 + b_orig.norm());
-    result.dual_infeas = rc.norm() / (1.0 + c_orig.norm());
-    result.gap = mu;
 
-    std::cout << "Current value: " << result.optimal_value << std::endl;
-    std::cout << "Current solution (x): " << result.x.transpose() << std::endl;
+    bool factor(const VectorN& d) { return factorNormalEquations(A, p, ne, d); }
+    bool solve(const VectorM& r, VectorM& y) { return solveNormalEquations(ne, r, y); }
+
+    // Scaled rows are diag(row_scaling) times the original ones
+    double unscaledNorm(const VectorM& r) const {
+        return scaling.is_scaled ? r.cwiseQuotient(scaling.row_scaling).norm() : r.norm();
+    }
+
+    const Eigen::Ref<const Eigen::MatrixXd>& A;
+    const Eigen::VectorXd& rhs;
+    const Eigen::VectorXd& cost;
+    const LPUtils::ScalingInfo& scaling;
+    const Parameters& p;
+    NormalEquations ne;
+};
+
+InteriorPointLP::Result InteriorPointLP::iterate(
+    const Parameters& p, const Eigen::Ref<const Eigen::MatrixXd>& A, const Eigen::VectorXd& b, const Eigen::VectorXd& c,
+    Eigen::VectorXd& x, Eigen::VectorXd& lambda, Eigen::VectorXd& s,
+    const LPUtils::ScalingInfo& scaling, double b_norm, double c_norm, double elapsed, Snapshot* snapshot)
+{
+    typedef PredictorCorrector<DenseBackend> Iteration;
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point setup_start = Clock::now();
+
+    Result result;
+
+    // Detect dense columns for the normal equations factorization
+    DenseBackend backend(A, b, c, scaling, p);
 
+    Clock::time_point iteration_start = Clock::now();
+    result.setup_time = std::chrono::duration<double>(iteration_start - setup_start).count();
+
+    Eigen::VectorXd rb, rc;
+    Iteration::Outcome outcome = Iteration::run(backend, p, x, lambda, s, rb, rc, b_norm, c_norm,
+                                                p.time_budget - elapsed - result.setup_time, snapshot);
+    result.status = outcome.status;
+    result.success = outcome.status == Status::Optimal;
+    result.iterations = outcome.iterations;
+
+    // The iterate itself stays in x, lambda and s for warm starts
+    Eigen::VectorXd x_out = x, lambda_out = lambda, s_out = s;
+    bool anytime_point = Iteration::useAnytimePoint(backend, outcome, x_out, lambda_out, s_out, rb, rc);
+    result.lower_bound = outcome.bounds.lower;
+    result.upper_bound = outcome.bounds.upper;
+    fillResult(result, x_out, lambda_out, s_out, rc, rb, c, scaling, b_norm, c_norm);
+    result.iteration_time = std::chrono::duration<double>(Clock::now() - iteration_start).count();
+
+    if (p.verbose) {
+        printSummary(result, outcome.status, anytime_point);
+    }
     return result;
 }
 
-void InteriorPointLP::computeInitialPoint(
-    const Eigen::MatrixXd& A, const Eigen::VectorXd& b, const Eigen::VectorXd& c,
-    Eigen::VectorXd& x, Eigen::VectorXd& lambda, Eigen::VectorXd& s) 
+void InteriorPointLP::shiftBlockingPairs(Eigen::VectorXd& x, Eigen::VectorXd& s, double fraction)
 {
-    const int n = c.size();
-    const int m = b.size();
-    
-    x = Eigen::VectorXd::Ones(n);
-    lambda = Eigen::VectorXd::Zero(m);
-    s = c - A.transpose() * lambda;
-    
-    double min_s = s.minCoeff();
-    if (min_s <= 1e-2) {
-        s = s - (min_s - 1.0) * Eigen::VectorXd::Ones(n);
+    const double target = fraction * x.dot(s) / x.size();
+    const double level = std::sqrt(target);
+    for (int i = 0; i < x.size(); i++) {
+        if (x(i) * s(i) >= target) {
+            continue;
+        }
+        if (std::max(x(i), s(i)) < level) {
+            x(i) = level;
+            s(i) = level;
+        } else if (x(i) < s(i)) {
+            x(i) = target / s(i);
+        } else {
+            s(i) = target / x(i);
+        }
     }
-    
-    double scaling_target = 1.0;
-    if (n > 1000) {
-        scaling_target = 10.0;
+}
+
+void InteriorPointLP::printSummary(const Result& result, Status status, bool anytime_point)
+{
+    switch (status) {
+    case Status::Optimal:
+        std::cout << "Converged after " << result.iterations << " iterations." << std::endl;
+        break;
+    case Status::GapReached:
+        std::cout << "Relative bound gap " << (result.upper_bound - result.lower_bound) / std::max(1.0, std::fabs(result.upper_bound))
+                  << " reached after " << result.iterations << " iterations." << std::endl;
+        break;
+    case Status::TimeLimit:
+        std::cout << "Time budget exhausted after " << result.iterations << " iterations." << std::endl;
+        break;
+    case Status::IterationLimit:
+    case Status::Breakdown:
+        std::cout << "Maximum iterations reached. Solution may not be optimal." << std::endl;
+        break;
     }
-    
-    Eigen::VectorXd xs = x.cwiseProduct(s);
-    double geo_mean = std::pow(xs.prod(), 1.0/n);
-    
-    if (!std::isfinite(geo_mean) || geo_mean < 1e-10) {
-        geo_mean = 1.0;
+
+    if (anytime_point) {
+        std::cout << "Bounds: [" << result.lower_bound << ", " << result.upper_bound << "]" << std::endl;
+    }
+    if (anytime_point && !result.success) {
+        std::cout << "Best feasible value: " << result.optimal_value << std::endl;
+    } else if (result.success) {
+        std::cout << "Optimal value: " << result.optimal_value << std::endl;
+        std::cout << "Optimal solution (x): " << result.x.transpose() << std::endl;
+    } else {
+        std::cout << "Current value: " << result.optimal_value << std::endl;
+        std::cout << "Current solution (x): " << result.x.transpose() << std::endl;
     }
-    
-    double scale_factor = std::sqrt(scaling_target/geo_mean);
-    x = x * scale_factor;
-    s = s / scale_factor;
 }
 
-void InteriorPointLP::computeAffineDirection(
-    const Eigen::MatrixXd& A, 
+void InteriorPointLP::fillResult(
+    Result& result,
     const Eigen::VectorXd& x, const Eigen::VectorXd& lambda, const Eigen::VectorXd& s,
-    Eigen::VectorXd& dx_aff, Eigen::VectorXd& dlambda_aff, Eigen::VectorXd& ds_aff,
-    const Eigen::VectorXd& rc, const Eigen::VectorXd& rb) 
+    const Eigen::VectorXd& rc, const Eigen::VectorXd& rb, const Eigen::VectorXd& c,
+    const LPUtils::ScalingInfo& scaling, double b_norm, double c_norm)
 {
-    Eigen::VectorXd rhs1 = -rc;
-    Eigen::VectorXd rhs2 = -rb;
-    Eigen::VectorXd rhs3 = -(x.array() * s.array()).matrix();
+    // The scaled objective equals the original one: c_s^T x_s = c^T x
+    result.optimal_value = c.dot(x);
+    result.primal_infeas = rb.norm() / (1.0 + b_norm);
+    result.dual_infeas = rc.norm() / (1.0 + c_norm);
+    result.gap = x.dot(s) / x.size();
     
-    solveLinearSystem(A, x, s, rhs1, rhs2, rhs3, dx_aff, dlambda_aff, ds_aff);
+    // Rescale solution if needed
+    result.x = x;
+    result.lambda = lambda;
+    result.s = s;
+    LPUtils::rescaleSolution(result.x, result.lambda, result.s, scaling);
+}
+
+void InteriorPointLP::computeInitialPoint(
+    const Eigen::VectorXd& b, const Eigen::VectorXd& c,
+    Eigen::VectorXd& x, Eigen::VectorXd& lambda, Eigen::VectorXd& s) 
+{
+    // With lambda = 0 the starting point does not depend on A
+    PredictorCorrector<DenseBackend>::initialPoint(c, b.size(), x, lambda, s);
 }
 
-void InteriorPointLP::computeStepLengths(
-    const Eigen::VectorXd& x, const Eigen::VectorXd& s,
-    const Eigen::VectorXd& dx, const Eigen::VectorXd& ds,
-    double& alpha_pri, double& alpha_dual) 
+void InteriorPointLP::analyzeNormalEquations(const Eigen::Ref<const Eigen::MatrixXd>& A, const Parameters& p,
+                                             NormalEquations& ne)
 {
-    alpha_pri = 1.0;
-    alpha_dual = 1.0;
+    const int m = A.rows();
+    const int n = A.cols();
     
-    const double STEP_THRESHOLD = -1e-12;
+    if (!p.split_dense_columns || m == 0) {
+        return;
+    }
     
-    for (int i = 0; i < x.size(); i++) {
-        if (dx(i) < STEP_THRESHOLD) {
-            double ratio = -x(i) / dx(i);
-            if (std::isfinite(ratio) && ratio < alpha_pri) {
-                alpha_pri = ratio;
-            }
-        }
+    // Classify columns by their number of nonzeros
+    std::vector<int> col_nnz(n);
+    for (int j = 0; j < n; j++) {
+        col_nnz[j] = (A.col(j).array() != 0.0).count();
+    }
+    if (!splitColumns(col_nnz, m, p, ne)) {
+        return;
     }
     
-    for (int i = 0; i < s.size(); i++) {
-        if (ds(i) < STEP_THRESHOLD) {
-            double ratio = -s(i) / ds(i);
-            if (std::isfinite(ratio) && ratio < alpha_dual) {
-                alpha_dual = ratio;
+    const int n_sparse = ne.sparse_cols.size();
+    const int n_dense = ne.dense_cols.size();
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int k = 0; k < n_sparse; k++) {
+        const int j = ne.sparse_cols[k];
+        for (int i = 0; i < m; i++) {
+            if (A(i, j) != 0.0) {
+                triplets.emplace_back(i, k, A(i, j));
             }
         }
     }
+    ne.A_sparse.resize(m, n_sparse);
+    ne.A_sparse.setFromTriplets(triplets.begin(), triplets.end());
+    
+    ne.A_dense.resize(m, n_dense);
+    for (int k = 0; k < n_dense; k++) {
+        ne.A_dense.col(k) = A.col(ne.dense_cols[k]);
+    }
     
-    if (!std::isfinite(alpha_pri) || alpha_pri < 0) alpha_pri = 0;
-    if (!std::isfinite(alpha_dual) || alpha_dual < 0) alpha_dual = 0;
+    ne.use_sparse = true;
+    
+    if (p.verbose) {
+        std::cout << "Using sparse normal equations with " << n_dense << " dense columns split off" << std::endl;
+    }
 }
 
-double InteriorPointLP::computeCenteringParameter(
-    const Eigen::VectorXd& x, const Eigen::VectorXd& s,
-    const Eigen::VectorXd& dx_aff, const Eigen::VectorXd& ds_aff,
-    double alpha_pri_aff, double alpha_dual_aff, double mu) 
+bool InteriorPointLP::splitColumns(const std::vector<int>& col_nnz, int m, const Parameters& p, NormalEquations& ne)
 {
-    const int n = x.size();
-    
-    double mu_aff = 0.0;
-    int count = 0;
-    
-    for (int i = 0; i < n; i++) {
-        double x_new = x(i) + alpha_pri_aff * dx_aff(i);
-        double s_new = s(i) + alpha_dual_aff * ds_aff(i);
-        
-        if (x_new > 0 && s_new > 0) {
-            mu_aff += x_new * s_new;
-            count++;
+    const int n = col_nnz.size();
+    ne.sparse_cols.clear();
+    ne.dense_cols.clear();
+    
+    long long sparse_nnz = 0;
+    for (int j = 0; j < n; j++) {
+        if (col_nnz[j] > p.dense_column_ratio * m) {
+            ne.dense_cols.push_back(j);
+        } else {
+            ne.sparse_cols.push_back(j);
+            sparse_nnz += col_nnz[j];
         }
     }
     
-    if (count == 0) {
-        mu_aff = mu;
-    } else {
-        mu_aff /= count;
+    // The split only pays off if the remaining columns are really sparse and
+    // the dense columns form a low-rank correction
+    const int n_sparse = ne.sparse_cols.size();
+    const int n_dense = ne.dense_cols.size();
+    if (n_sparse == 0 || n_dense >= m) {
+        return false;
     }
-    
-    if (mu_aff < 1e-14) mu_aff = 1e-14;
-    if (mu < 1e-14) mu = 1e-14;
-    
-    double sigma = std::pow(mu_aff / mu, 3);
-    
-    if (sigma < 0.01) sigma = 0.01;
-    if (sigma > 0.5) sigma = 0.5;
-    
-    return sigma;
+    return sparse_nnz <= p.sparse_density * double(m) * n_sparse;
 }
 
-void InteriorPointLP::computeCombinedDirection(
-    const Eigen::MatrixXd& A,
-    const Eigen::VectorXd& x, const Eigen::VectorXd& lambda, const Eigen::VectorXd& s,
-    const Eigen::VectorXd& dx_aff, const Eigen::VectorXd& ds_aff,
-    Eigen::VectorXd& dx, Eigen::VectorXd& dlambda, Eigen::VectorXd& ds,
-    const Eigen::VectorXd& rc, const Eigen::VectorXd& rb,
-    double sigma, double mu) 
+bool InteriorPointLP::factorNormalEquations(
+    const Eigen::Ref<const Eigen::MatrixXd>& A, const Parameters& p, NormalEquations& ne, const Eigen::VectorXd& d)
 {
-    const int n = x.size();
+    if (ne.use_sparse) {
+        return factorSplitNormalEquations(ne, p, d);
+    }
     
-    Eigen::VectorXd corrector(n);
+    Eigen::MatrixXd AD = A * d.asDiagonal();
+    Eigen::MatrixXd normal = AD * A.transpose();
+    return factorDenseNormalEquations(normal, p, ne);
+}
+
+bool InteriorPointLP::factorDenseNormalEquations(Eigen::MatrixXd& normal, const Parameters& p, NormalEquations& ne)
+{
+    for (int i = 0; i < normal.rows(); i++) {
+        normal(i, i) += p.regularization * (1.0 + normal(i, i));
+    }
     
-    for (int i = 0; i < n; i++) {
-        if (std::fabs(dx_aff(i)) > 1e6 || std::fabs(ds_aff(i)) > 1e6) {
-            corrector(i) = 0;
-        } else {
-            corrector(i) = dx_aff(i) * ds_aff(i);
-        }
+    try {
+        ne.dense_ldlt.compute(normal);
     }
+    catch (const std::exception&) {
+        return false;
+    }
+    return ne.dense_ldlt.info() == Eigen::Success;
+}
+
+bool InteriorPointLP::factorSplitNormalEquations(NormalEquations& ne, const Parameters& p, const Eigen::VectorXd& d)
+{
+    typedef Eigen::SparseMatrix<double> SpMat;
     
-    Eigen::VectorXd rhs1 = -rc;
-    Eigen::VectorXd rhs2 = -rb;
-    Eigen::VectorXd rhs3 = -(x.array() * s.array()).matrix() - corrector + sigma * mu * Eigen::VectorXd::Ones(n);
+    const int n_sparse = ne.sparse_cols.size();
+    const int n_dense = ne.dense_cols.size();
     
-    solveLinearSystem(A, x, s, rhs1, rhs2, rhs3, dx, dlambda, ds);
+    Eigen::VectorXd d_sparse(n_sparse);
+    ne.d_dense.resize(n_dense);
+    for (int k = 0; k < n_sparse; k++) d_sparse(k) = d(ne.sparse_cols[k]);
+    for (int k = 0; k < n_dense; k++) ne.d_dense(k) = d(ne.dense_cols[k]);
+    
+    // Sparse part M_s = A_s D_s A_s^T. The product keeps its structural
+    // pattern, so the symbolic analysis is done only once per solve.
+    SpMat AD = ne.A_sparse * d_sparse.asDiagonal();
+    ne.M_sparse = AD * ne.A_sparse.transpose();
+    return factorFormedSplitNormalEquations(ne, p);
 }
 
-bool InteriorPointLP::solveLinearSystem(
-    const Eigen::MatrixXd& A,
-    const Eigen::VectorXd& x, const Eigen::VectorXd& s,
-    const Eigen::VectorXd& rhs1, const Eigen::VectorXd& rhs2, const Eigen::VectorXd& rhs3,
-    Eigen::VectorXd& dx, Eigen::VectorXd& dlambda, Eigen::VectorXd& ds) 
+bool InteriorPointLP::factorFormedSplitNormalEquations(NormalEquations& ne, const Parameters& p)
 {
-    const int n = x.size();
-    const int m = A.rows();
+    typedef Eigen::SparseMatrix<double> SpMat;
+    
+    const int m = ne.M_sparse.rows();
+    const int n_dense = ne.dense_cols.size();
+    ne.use_augmented = false;
+    
+    // Dense columns contribute U U^T with U = A_d D_d^(1/2). The regularization
+    // is based on the diagonal of the full matrix, as in the dense path.
+    ne.U = ne.A_dense * ne.d_dense.cwiseSqrt().asDiagonal();
+    Eigen::VectorXd full_diagonal = Eigen::VectorXd(ne.M_sparse.diagonal()) + ne.U.rowwise().squaredNorm();
+    
+    // The sparse part gets the usual diagonal regularization
+    SpMat reg(m, m);
+    reg.setIdentity();
+    reg.diagonal() = p.regularization * (Eigen::VectorXd::Ones(m) + full_diagonal);
+    ne.M_sparse += reg;
+    
+    if (!ne.analyzed) {
+        ne.ldlt.analyzePattern(ne.M_sparse);
+        ne.analyzed = true;
+    }
+    ne.ldlt.factorize(ne.M_sparse);
+    if (ne.ldlt.info() != Eigen::Success) {
+        return false;
+    }
+    if (n_dense == 0) {
+        return true;
+    }
     
-    Eigen::VectorXd d(n);
-    for (int i = 0; i < n; i++) {
-        if (s(i) < 1e-14) {
-            d(i) = x(i) / 1e-14;
-        } else {
-            d(i) = x(i) / s(i);
-        }
-        
-        if (d(i) < 1e-12) d(i) = 1e-12;
-        if (d(i) > 1e12) d(i) = 1e12;
+    // Sherman-Morrison-Woodbury with M = M_s + U U^T:
+    // M^-1 r = y - Y (I + U^T Y)^-1 U^T y with y = M_s^-1 r, Y = M_s^-1 U
+    ne.Y = ne.ldlt.solve(ne.U);
+    ne.small_ldlt.compute(Eigen::MatrixXd::Identity(n_dense, n_dense) + ne.U.transpose() * ne.Y);
+    if (ne.small_ldlt.info() == Eigen::Success) {
+        return true;
     }
     
-    Eigen::MatrixXd D = d.asDiagonal();
+    // The low-rank correction is unstable
+    return factorAugmentedNormalEquations(ne);
+}
+
+bool InteriorPointLP::factorAugmentedNormalEquations(NormalEquations& ne)
+{
+    typedef Eigen::SparseMatrix<double> SpMat;
     
-    Eigen::MatrixXd AD = A * D;
-    Eigen::MatrixXd M = AD * A.transpose();
+    const int m = ne.M_sparse.rows();
+    const int n_dense = ne.dense_cols.size();
     
-    for (int i = 0; i < M.rows(); i++) {
-        M(i, i) += params.regularization * (1.0 + M(i, i));
+    // Quasi-definite augmented system [M_s A_d; A_d^T -D_d^-1] [dlambda; w] = [rhs; 0]
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(ne.M_sparse.nonZeros() + 2 * ne.A_dense.size() + n_dense);
+    for (int k = 0; k < ne.M_sparse.outerSize(); k++) {
+        for (SpMat::InnerIterator it(ne.M_sparse, k); it; ++it) {
+            triplets.emplace_back(it.row(), it.col(), it.value());
+        }
     }
-    
-    Eigen::VectorXd rhs_temp(n);
-    for (int i = 0; i < n; i++) {
-        if (std::fabs(s(i)) < 1e-14) {
-            rhs_temp(i) = rhs3(i) / 1e-14;
-        } else {
-            rhs_temp(i) = rhs3(i) / s(i);
+    for (int k = 0; k < n_dense; k++) {
+        for (int i = 0; i < m; i++) {
+            if (ne.A_dense(i, k) != 0.0) {
+                triplets.emplace_back(i, m + k, ne.A_dense(i, k));
+                triplets.emplace_back(m + k, i, ne.A_dense(i, k));
+            }
         }
-        
-        if (rhs_temp(i) < -1e12) rhs_temp(i) = -1e12;
-        if (rhs_temp(i) > 1e12) rhs_temp(i) = 1e12;
+        triplets.emplace_back(m + k, m + k, -1.0 / ne.d_dense(k));
     }
+    SpMat K(m + n_dense, m + n_dense);
+    K.setFromTriplets(triplets.begin(), triplets.end());
     
-    Eigen::VectorXd rhs_lambda = rhs2 - A * (D * rhs1 + rhs_temp);
-    
-    if (LPUtils::containsNanOrInf(rhs_lambda)) {
-        return false;
+    if (!ne.augmented_analyzed) {
+        ne.augmented_ldlt.analyzePattern(K);
+        ne.augmented_analyzed = true;
+    }
+    ne.augmented_ldlt.factorize(K);
+    ne.use_augmented = ne.augmented_ldlt.info() == Eigen::Success;
+    return ne.use_augmented;
+}
+
+bool InteriorPointLP::solveNormalEquations(NormalEquations& ne, const Eigen::VectorXd& rhs, Eigen::VectorXd& dlambda)
+{
+    if (!ne.use_sparse) {
+        dlambda = ne.dense_ldlt.solve(rhs);
+        return !LPUtils::containsNanOrInf(dlambda);
     }
     
-    try {
-        Eigen::LDLT<Eigen::MatrixXd> ldlt(M);
-        if (ldlt.info() != Eigen::Success) {
-            return false;
+    if (!ne.use_augmented) {
+        Eigen::VectorXd y = ne.ldlt.solve(rhs);
+        if (ne.dense_cols.empty()) {
+            dlambda = y;
+            return !LPUtils::containsNanOrInf(dlambda);
         }
+        dlambda = y - ne.Y * ne.small_ldlt.solve(ne.U.transpose() * y);
         
-        dlambda = ldlt.solve(rhs_lambda);
+        // The correction cancels against y when M_s is much worse conditioned
+        // than M = M_s + U U^T, so the solve is checked against M itself
+        if (!LPUtils::containsNanOrInf(dlambda)) {
+            Eigen::VectorXd residual = ne.M_sparse * dlambda + ne.U * (ne.U.transpose() * dlambda) - rhs;
+            if (residual.norm() <= SMW_RESIDUAL_TOL * rhs.norm()) {
+                return true;
+            }
+        }
         
-        if (LPUtils::containsNanOrInf(dlambda)) {
+        // The low-rank correction is not accurate enough on this right-hand side
+        if (!factorAugmentedNormalEquations(ne)) {
             return false;
         }
     }
-    catch (const std::exception&) {
-        return false;
-    }
     
-    dx = D * (A.transpose() * dlambda - rhs1) + rhs_temp;
+    const int m = ne.M_sparse.rows();
+    Eigen::VectorXd rhs_augmented = Eigen::VectorXd::Zero(m + ne.dense_cols.size());
+    rhs_augmented.head(m) = rhs;
+    dlambda = ne.augmented_ldlt.solve(rhs_augmented).head(m);
     
-    ds.resize(n);
-    for (int i = 0; i < n; i++) {
-        if (x(i) < 1e-12) {
-            ds(i) = (rhs3(i) - s(i) * dx(i)) / 1e-12;
-        } else {
-            ds(i) = (rhs3(i) - s(i) * dx(i)) / x(i);
-        }
-        
-        if (ds(i) < -1e12) ds(i) = -1e12;
-        if (ds(i) > 1e12) ds(i) = 1e12;
-    }
-    
-    return true;
-}
-
-bool InteriorPointLP::checkConvergence(
-    const Eigen::VectorXd& x, const Eigen::VectorXd& lambda, const Eigen::VectorXd& s,
-    const Eigen::VectorXd& rc, const Eigen::VectorXd& rb, double mu,
-    const Eigen::VectorXd& b_orig, const Eigen::VectorXd& c_orig) 
-{
-    double primal_infeas = rb.norm() / (1.0 + b_orig.norm());
-    double dual_infeas = rc.norm() / (1.0 + c_orig.norm());
-    double gap = mu;
-    
-    return (primal_infeas < params.tol && dual_infeas < params.tol && gap < params.tol);
+    return !LPUtils::containsNanOrInf(dlambda);
 }
 
 void InteriorPointLP::setParameters(const Parameters& p) {
     params = p;
 }
+
+const InteriorPointLP::Parameters& InteriorPointLP::getParameters() {
+    return params;
+}
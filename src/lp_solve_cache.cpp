@@ -0,0 +1,522 @@
+#include "lp_solve_cache.h"
+#include "tiny_lp.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const std::uint64_t PRIME = 0x9E3779B97F4A7C15ULL;
+const std::uint64_t CHECK_PRIME = 0xC2B2AE3D27D4EB4FULL;
+const std::uint64_t WARM_START_TAG = 0x5741524D53544152ULL;
+const std::uint32_t FILE_VERSION = 4;
+
+// Relative duality gap at which a solve keeps its iterate as the warm-start
+// point (see InteriorPointLP::Snapshot), and the pairs shifted before reuse
+const double WARM_START_LEVEL = 1.0;
+const double SHIFT_FRACTION = 1e-1;
+
+// Smallest iteration allowance of a warm start before it falls back to a cold solve
+const int MIN_WARM_ITERATIONS = 20;
+
+// Final avalanche of MurmurHash3
+std::uint64_t mix(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+std::uint64_t combine(std::uint64_t seed, std::uint64_t value) {
+    return mix(seed ^ (value * PRIME));
+}
+
+// 64-bit hash of a byte range. Four independent lanes consume 32 bytes per
+// step, so hashing runs at memory speed rather than one multiply per word.
+std::uint64_t hashBytes(std::uint64_t seed, const void* data, std::size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    std::uint64_t lanes[4] = {seed, seed + PRIME, seed ^ PRIME, seed - PRIME};
+
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int l = 0; l < 4; l++) {
+            std::uint64_t word;
+            std::memcpy(&word, p + i + 8 * l, 8);
+            lanes[l] = (lanes[l] ^ word) * PRIME;
+            lanes[l] ^= lanes[l] >> 29;
+        }
+    }
+
+    std::uint64_t h = combine(seed, size);
+    for (int l = 0; l < 4; l++) {
+        h = combine(h, lanes[l]);
+    }
+    for (; i < size; i++) {
+        h = (h ^ p[i]) * PRIME;
+    }
+    return mix(h);
+}
+
+std::uint64_t hashMatrix(std::uint64_t seed, const Eigen::MatrixXd& M) {
+    seed = combine(combine(seed, M.rows()), M.cols());
+    return hashBytes(seed, M.data(), sizeof(double) * M.size());
+}
+
+std::uint64_t hashVector(std::uint64_t seed, const Eigen::VectorXd& v) {
+    seed = combine(seed, v.size());
+    return hashBytes(seed, v.data(), sizeof(double) * v.size());
+}
+
+// Hash of the parameters that change the result (not the output settings)
+std::uint64_t hashParameters(std::uint64_t seed, const InteriorPointLP::Parameters& params) {
+    const double values[] = {
+        params.tol, double(params.max_iter), params.eta, params.regularization,
+        double(params.use_scaling), double(params.split_dense_columns),
+        params.dense_column_ratio, params.sparse_density, double(params.use_tiny_kernels),
+        params.time_budget, params.gap_target
+    };
+    return hashBytes(seed, values, sizeof(values));
+}
+
+// Second digest of a byte range, used to confirm exact hits. It shares no
+// structure with hashBytes (one serial lane, rotate-multiply steps, another
+// multiplier), so data that collides in one is not expected to collide in
+// the other.
+std::uint64_t checkBytes(std::uint64_t seed, const void* data, std::size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    std::uint64_t h = seed ^ (size * CHECK_PRIME);
+
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, p + i, 8);
+        h ^= word;
+        h = ((h << 31) | (h >> 33)) * CHECK_PRIME;
+    }
+    for (; i < size; i++) {
+        h ^= p[i];
+        h = ((h << 7) | (h >> 57)) * CHECK_PRIME;
+    }
+    return mix(h);
+}
+
+// Second digest of everything the result key covers
+std::uint64_t checkProblem(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, const Eigen::VectorXd& c,
+                           const InteriorPointLP::Parameters& params) {
+    const double values[] = {
+        double(A.rows()), double(A.cols()),
+        params.tol, double(params.max_iter), params.eta, params.regularization,
+        double(params.use_scaling), double(params.split_dense_columns),
+        params.dense_column_ratio, params.sparse_density, double(params.use_tiny_kernels),
+        params.time_budget, params.gap_target
+    };
+    std::uint64_t h = checkBytes(CHECK_PRIME, values, sizeof(values));
+    h = checkBytes(h, A.data(), sizeof(double) * A.size());
+    h = checkBytes(h, b.data(), sizeof(double) * b.size());
+    return checkBytes(h, c.data(), sizeof(double) * c.size());
+}
+
+void writeVector(std::ofstream& out, const Eigen::VectorXd& v) {
+    const std::uint64_t size = v.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char*>(v.data()), sizeof(double) * v.size());
+}
+
+bool readVector(std::ifstream& in, Eigen::VectorXd& v, Eigen::Index max_size) {
+    std::uint64_t size = 0;
+    if (!in.read(reinterpret_cast<char*>(&size), sizeof(size)) || size > std::uint64_t(max_size)) {
+        return false;
+    }
+    v.resize(size);
+    return bool(in.read(reinterpret_cast<char*>(v.data()), sizeof(double) * size));
+}
+
+template <typename T>
+void writeValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& in, T& value) {
+    return bool(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Only results that do not depend on timing or on running out of
+// iterations are worth replaying: a time limit, an iteration limit or a
+// breakdown is solved again when the problem comes back
+bool isReusable(const InteriorPointLP::Result& result) {
+    return result.status == InteriorPointLP::Status::Optimal ||
+           result.status == InteriorPointLP::Status::GapReached;
+}
+
+} // namespace
+
+LPSolveCache::LPSolveCache(std::size_t max_bytes_, const std::string& directory_)
+    : max_bytes(max_bytes_), directory(directory_)
+{
+    if (!directory.empty()) {
+        fs::create_directories(directory);
+    }
+}
+
+InteriorPointLP::Result LPSolveCache::solve(const Eigen::MatrixXd& A_orig, const Eigen::VectorXd& b_orig,
+                                            const Eigen::VectorXd& c_orig, Source* source)
+{
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point setup_start = Clock::now();
+    const InteriorPointLP::Parameters& params = InteriorPointLP::getParameters();
+
+    if (A_orig.rows() != b_orig.size()) {
+        throw std::invalid_argument("Matrix A rows must match vector b size");
+    }
+    if (A_orig.cols() != c_orig.size()) {
+        throw std::invalid_argument("Matrix A columns must match vector c size");
+    }
+    const Eigen::Index m = A_orig.rows();
+    const Eigen::Index n = A_orig.cols();
+
+    // The warm-start point depends on (A, b) and on whether they were scaled;
+    // the result depends on everything
+    const std::uint64_t system_key = hashVector(hashMatrix(params.use_scaling, A_orig), b_orig);
+    const std::uint64_t result_key = hashParameters(hashVector(system_key, c_orig), params);
+    const std::uint64_t warm_key = combine(system_key, WARM_START_TAG);
+
+    // An exact hit must also match the second digest; a mismatch is a
+    // collision of the result key and is solved (and replaced) as a miss
+    bool from_disk = false;
+    const std::uint64_t check = checkProblem(A_orig, b_orig, c_orig, params);
+    EntryPtr cached = find(result_key, Kind::Result, m, n, from_disk);
+    if (cached && cached->check == check) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            (from_disk ? counters.disk_hits : counters.exact_hits)++;
+        }
+        if (source) {
+            *source = Source::Cached;
+        }
+        InteriorPointLP::Result result = cached->result;
+        result.setup_time = 0.0;
+        result.iteration_time = 0.0;
+        return result;
+    }
+
+    EntryPtr warm = find(warm_key, Kind::WarmStart, m, n, from_disk);
+
+    InteriorPointLP::Result result;
+    auto stored = std::make_shared<Entry>();
+    stored->key = result_key;
+    stored->kind = Kind::Result;
+    stored->check = check;
+
+    // Very small problems go to a fixed-size kernel, as in InteriorPointLP::solve;
+    // there is no iterate worth keeping for them
+    if (!warm && params.use_tiny_kernels && solveTinyLP(A_orig, b_orig, c_orig, params, result)) {
+        result.iteration_time = std::chrono::duration<double>(Clock::now() - setup_start).count();
+        if (isReusable(result)) {
+            stored->result = result;
+            stored->bytes = sizeof(Entry) + sizeof(double) * (2 * n + m);
+            insert(stored, true);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            counters.misses++;
+        }
+        if (source) {
+            *source = Source::Solved;
+        }
+        return result;
+    }
+
+    Eigen::MatrixXd A = A_orig;
+    Eigen::VectorXd b = b_orig;
+    Eigen::VectorXd c = c_orig;
+    LPUtils::ScalingInfo scaling;
+    Eigen::VectorXd x, lambda, s;
+    InteriorPointLP::Snapshot snapshot;
+    snapshot.gap = WARM_START_LEVEL;
+    snapshot.residual = 1e-1 * WARM_START_LEVEL;
+    int cold_iterations = 0;
+    int warm_iterations = 0;
+
+    if (warm) {
+        // Apply the stored scaling instead of recomputing it
+        scaling = warm->scaling;
+        if (scaling.is_scaled) {
+            A = scaling.row_scaling.asDiagonal() * A * scaling.col_scaling.asDiagonal();
+            b = b.cwiseProduct(scaling.row_scaling);
+            c = c.cwiseProduct(scaling.col_scaling);
+        }
+        cold_iterations = warm->cold_iterations;
+    } else if (params.use_scaling) {
+        scaling = LPUtils::scaleLP(A, b, c);
+    }
+
+    double setup_time = std::chrono::duration<double>(Clock::now() - setup_start).count();
+    bool warm_started = false;
+    if (warm) {
+        // Start from the kept iterate with only its blocking pairs shifted; a
+        // warm start that takes longer than the cold solve of this system did
+        // is abandoned for a cold solve
+        x = warm->x;
+        lambda = warm->lambda;
+        s = warm->s;
+        InteriorPointLP::shiftBlockingPairs(x, s, SHIFT_FRACTION);
+        InteriorPointLP::Parameters warm_params = params;
+        warm_params.max_iter = std::min(params.max_iter, std::max(MIN_WARM_ITERATIONS, cold_iterations));
+
+        result = InteriorPointLP::iterate(warm_params, A, b, c, x, lambda, s, scaling, b_orig.norm(), c_orig.norm(),
+                                          setup_time, &snapshot);
+        // A stop at the time budget or the gap target ends the solve as well
+        warm_started = result.status != InteriorPointLP::Status::IterationLimit &&
+                       result.status != InteriorPointLP::Status::Breakdown;
+        if (!warm_started) {
+            warm_iterations = result.iterations;
+            setup_time += result.setup_time + result.iteration_time;
+            snapshot.taken = false;
+        }
+    }
+
+    if (!warm_started) {
+        InteriorPointLP::computeInitialPoint(b, c, x, lambda, s);
+        result = InteriorPointLP::iterate(params, A, b, c, x, lambda, s, scaling, b_orig.norm(), c_orig.norm(),
+                                          setup_time, &snapshot);
+        if (result.success) {
+            cold_iterations = result.iterations;
+        }
+        result.iterations += warm_iterations;
+    }
+    result.setup_time += setup_time;
+
+    if (isReusable(result)) {
+        stored->result = result;
+        stored->bytes = sizeof(Entry) + sizeof(double) * (2 * n + m);
+        insert(stored, true);
+    }
+
+    // Keep the iterate at the warm-start level, or the final one if the run
+    // never got there
+    if (snapshot.taken) {
+        x = snapshot.x;
+        lambda = snapshot.lambda;
+        s = snapshot.s;
+    }
+    if (!LPUtils::containsNanOrInf(x) && !LPUtils::containsNanOrInf(lambda) && !LPUtils::containsNanOrInf(s)) {
+        auto point = std::make_shared<Entry>();
+        point->key = warm_key;
+        point->kind = Kind::WarmStart;
+        point->scaling = scaling;
+        point->x = x;
+        point->lambda = lambda;
+        point->s = s;
+        point->cold_iterations = cold_iterations;
+        point->bytes = sizeof(Entry) + sizeof(double) * (3 * n + 2 * m);
+        insert(point, true);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        (warm_started ? counters.warm_starts : counters.misses)++;
+    }
+    if (source) {
+        *source = warm_started ? Source::WarmStarted : Source::Solved;
+    }
+    return result;
+}
+
+LPSolveCache::Stats LPSolveCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats result = counters;
+    result.entries = lru.size();
+    return result;
+}
+
+void LPSolveCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    lru.clear();
+    index.clear();
+    counters = Stats();
+}
+
+LPSolveCache::EntryPtr LPSolveCache::find(std::uint64_t key, Kind kind, Eigen::Index m, Eigen::Index n,
+                                          bool& from_disk)
+{
+    from_disk = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            EntryPtr entry = *it->second;
+            lru.splice(lru.begin(), lru, it->second);
+            // Same size checks as readEntry: a key collision between
+            // problems of different shape must not hand out a wrong-sized point
+            const Eigen::VectorXd& x = kind == Kind::Result ? entry->result.x : entry->x;
+            const Eigen::VectorXd& lambda = kind == Kind::Result ? entry->result.lambda : entry->lambda;
+            if (entry->kind != kind || x.size() != n || lambda.size() != m) {
+                return nullptr;
+            }
+            return entry;
+        }
+    }
+
+    if (directory.empty()) {
+        return nullptr;
+    }
+    std::shared_ptr<Entry> entry = readEntry(key, kind, m, n);
+    if (!entry) {
+        return nullptr;
+    }
+    from_disk = true;
+    insert(entry, false);
+    return entry;
+}
+
+void LPSolveCache::insert(const std::shared_ptr<Entry>& entry, bool persist) {
+    if (persist && !directory.empty()) {
+        writeEntry(*entry);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(entry->key);
+    if (it != index.end()) {
+        counters.bytes -= (*it->second)->bytes;
+        lru.erase(it->second);
+        index.erase(it);
+    }
+    if (entry->bytes > max_bytes) {
+        return;
+    }
+
+    lru.push_front(entry);
+    index[entry->key] = lru.begin();
+    counters.bytes += entry->bytes;
+
+    while (counters.bytes > max_bytes) {
+        counters.bytes -= lru.back()->bytes;
+        index.erase(lru.back()->key);
+        lru.pop_back();
+        counters.evictions++;
+    }
+}
+
+std::string LPSolveCache::entryPath(std::uint64_t key, Kind kind) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.%s", static_cast<unsigned long long>(key),
+                  kind == Kind::Result ? "result" : "warm");
+    return (fs::path(directory) / name).string();
+}
+
+void LPSolveCache::writeEntry(const Entry& entry) const {
+    // Write to a private temporary file and rename it into place, so readers
+    // in other threads or processes never see a partial entry
+    const std::string path = entryPath(entry.key, entry.kind);
+    std::ostringstream tmp;
+    tmp << path << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id());
+    {
+        std::ofstream out(tmp.str(), std::ios::binary);
+        if (!out) {
+            return;
+        }
+        out.write("LPRC", 4);
+        writeValue(out, FILE_VERSION);
+        writeValue(out, static_cast<std::uint32_t>(entry.kind));
+        writeValue(out, entry.key);
+        if (entry.kind == Kind::Result) {
+            const InteriorPointLP::Result& r = entry.result;
+            writeValue(out, entry.check);
+            writeValue(out, static_cast<std::uint8_t>(r.status));
+            writeValue(out, static_cast<std::int32_t>(r.iterations));
+            writeValue(out, r.optimal_value);
+            writeValue(out, r.primal_infeas);
+            writeValue(out, r.dual_infeas);
+            writeValue(out, r.gap);
+            writeValue(out, r.setup_time);
+            writeValue(out, r.iteration_time);
+            writeValue(out, r.lower_bound);
+            writeValue(out, r.upper_bound);
+            writeVector(out, r.x);
+            writeVector(out, r.lambda);
+            writeVector(out, r.s);
+        } else {
+            writeValue(out, static_cast<std::int32_t>(entry.cold_iterations));
+            writeValue(out, static_cast<std::uint8_t>(entry.scaling.is_scaled));
+            writeVector(out, entry.scaling.row_scaling);
+            writeVector(out, entry.scaling.col_scaling);
+            writeVector(out, entry.x);
+            writeVector(out, entry.lambda);
+            writeVector(out, entry.s);
+        }
+        if (!out) {
+            out.close();
+            fs::remove(tmp.str());
+            return;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmp.str(), path, ec);
+    if (ec) {
+        fs::remove(tmp.str(), ec);
+    }
+}
+
+std::shared_ptr<LPSolveCache::Entry> LPSolveCache::readEntry(std::uint64_t key, Kind kind,
+                                                             Eigen::Index m, Eigen::Index n) const
+{
+    std::ifstream in(entryPath(key, kind), std::ios::binary);
+    if (!in) {
+        return nullptr;
+    }
+
+    char magic[4];
+    std::uint32_t version = 0, stored_kind = 0;
+    std::uint64_t stored_key = 0;
+    if (!in.read(magic, 4) || std::memcmp(magic, "LPRC", 4) != 0
+        || !readValue(in, version) || version != FILE_VERSION
+        || !readValue(in, stored_kind) || stored_kind != static_cast<std::uint32_t>(kind)
+        || !readValue(in, stored_key) || stored_key != key) {
+        return nullptr;
+    }
+
+    auto entry = std::make_shared<Entry>();
+    entry->key = key;
+    entry->kind = kind;
+    bool ok;
+    if (kind == Kind::Result) {
+        InteriorPointLP::Result& r = entry->result;
+        std::uint8_t status = 0;
+        std::int32_t iterations = 0;
+        ok = readValue(in, entry->check) && readValue(in, status) && readValue(in, iterations)
+            && readValue(in, r.optimal_value) && readValue(in, r.primal_infeas)
+            && readValue(in, r.dual_infeas) && readValue(in, r.gap)
+            && readValue(in, r.setup_time) && readValue(in, r.iteration_time)
+            && readValue(in, r.lower_bound) && readValue(in, r.upper_bound)
+            && readVector(in, r.x, n) && readVector(in, r.lambda, m) && readVector(in, r.s, n)
+            && r.x.size() == n && r.lambda.size() == m && r.s.size() == n;
+        r.status = static_cast<InteriorPointLP::Status>(status);
+        r.success = r.status == InteriorPointLP::Status::Optimal;
+        r.iterations = iterations;
+        entry->bytes = sizeof(Entry) + sizeof(double) * (2 * n + m);
+    } else {
+        std::int32_t cold_iterations = 0;
+        std::uint8_t is_scaled = 0;
+        ok = readValue(in, cold_iterations) && readValue(in, is_scaled)
+            && readVector(in, entry->scaling.row_scaling, m) && readVector(in, entry->scaling.col_scaling, n)
+            && readVector(in, entry->x, n) && readVector(in, entry->lambda, m) && readVector(in, entry->s, n)
+            && entry->x.size() == n && entry->lambda.size() == m && entry->s.size() == n
+            && (!is_scaled || (entry->scaling.row_scaling.size() == m && entry->scaling.col_scaling.size() == n));
+        entry->scaling.is_scaled = is_scaled != 0;
+        entry->cold_iterations = cold_iterations;
+        entry->bytes = sizeof(Entry) + sizeof(double) * (3 * n + 2 * m);
+    }
+    return ok ? entry : nullptr;
+}
@@ -1,10 +1,18 @@
 #include "lp_utils.h"
 #include <limits>
 #include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
 
 namespace LPUtils {
 
+// Set limits for scaling factors to avoid extreme scaling
+static const double MAX_SCALING = 1e6;
+static const double MIN_SCALING = 1e-6;
+
 LPUtils::ScalingInfo scaleLP(Eigen::MatrixXd& A, Eigen::VectorXd& b, Eigen::VectorXd& c) {
     ScalingInfo scaling;
     const int m = A.rows();
@@ -21,10 +29,6 @@ LPUtils::ScalingInfo scaleLP(Eigen::MatrixXd& A, Eigen::VectorXd& b, Eigen::Vect
     scaling.row_scaling = Eigen::VectorXd::Ones(m);
     scaling.col_scaling = Eigen::VectorXd::Ones(n);
     
-    // Set limits for scaling factors to avoid extreme scaling
-    const double MAX_SCALING = 1e6;
-    const double MIN_SCALING = 1e-6;
-    
     // Iterative scaling (similar to matrix equilibration)
     for (int iter = 0; iter < 5; iter++) {
         // Scale rows
@@ -53,6 +57,50 @@ LPUtils::ScalingInfo scaleLP(Eigen::MatrixXd& A, Eigen::VectorXd& b, Eigen::Vect
     return scaling;
 }
 
+void scaleNewRows(Eigen::MatrixXd& A_rows, Eigen::VectorXd& b_rows, ScalingInfo& scaling) {
+    if (!scaling.is_scaled) {
+        return;
+    }
+    
+    const int m = scaling.row_scaling.size();
+    const int k = A_rows.rows();
+    A_rows = A_rows * scaling.col_scaling.asDiagonal();
+    
+    scaling.row_scaling.conservativeResize(m + k);
+    for (int i = 0; i < k; i++) {
+        double row_max = A_rows.row(i).cwiseAbs().maxCoeff();
+        double scale = 1.0;
+        if (row_max > 0) {
+            scale = std::min(std::max(1.0 / row_max, MIN_SCALING), MAX_SCALING);
+        }
+        A_rows.row(i) *= scale;
+        b_rows(i) *= scale;
+        scaling.row_scaling(m + i) = scale;
+    }
+}
+
+void scaleNewColumns(Eigen::MatrixXd& A_cols, Eigen::VectorXd& c_cols, ScalingInfo& scaling) {
+    if (!scaling.is_scaled) {
+        return;
+    }
+    
+    const int n = scaling.col_scaling.size();
+    const int k = A_cols.cols();
+    A_cols = scaling.row_scaling.asDiagonal() * A_cols;
+    
+    scaling.col_scaling.conservativeResize(n + k);
+    for (int j = 0; j < k; j++) {
+        double col_max = A_cols.col(j).cwiseAbs().maxCoeff();
+        double scale = 1.0;
+        if (col_max > 0) {
+            scale = std::min(std::max(1.0 / col_max, MIN_SCALING), MAX_SCALING);
+        }
+        A_cols.col(j) *= scale;
+        c_cols(j) *= scale;
+        scaling.col_scaling(n + j) = scale;
+    }
+}
+
 void rescaleSolution(Eigen::VectorXd& x, Eigen::VectorXd& lambda, Eigen::VectorXd& s, 
                       const ScalingInfo& scaling) {
     if (!scaling.is_scaled) {
@@ -64,9 +112,9 @@ void rescaleSolution(Eigen::VectorXd& x, Eigen::VectorXd& lambda, Eigen::VectorX
         x(i) *= scaling.col_scaling(i);
     }
     
-    // Rescale dual variables
+    // Rescale dual variables (A_s = R A Q, so lambda = R lambda_s)
     for (int i = 0; i < lambda.size(); i++) {
-        lambda(i) /= scaling.row_scaling(i);
+        lambda(i) *= scaling.row_scaling(i);
     }
     
     // Rescale slack variables
@@ -75,6 +123,63 @@ void rescaleSolution(Eigen::VectorXd& x, Eigen::VectorXd& lambda, Eigen::VectorX
     }
 }
 
+void readLPData(const std::string& filename, Eigen::MatrixXd &A, Eigen::VectorXd &b, Eigen::VectorXd &c, int &numVars, int &numConstraints) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    
+    std::string line;
+    // Read first line: numVars and numConstraints
+    std::getline(file, line);
+    std::istringstream iss_header(line);
+    if (!(iss_header >> numVars >> numConstraints)) {
+        throw std::runtime_error("Error reading dimensions.");
+    }
+    
+    // Read objective coefficients (line 2)
+    std::getline(file, line);
+    std::istringstream iss_obj(line);
+    std::vector<double> c_values;
+    double val;
+    while (iss_obj >> val) {
+        c_values.push_back(val);
+    }
+    if (c_values.size() != static_cast<size_t>(numVars)) {
+        throw std::runtime_error("Objective coefficients count mismatch.");
+    }
+    c = Eigen::VectorXd::Map(c_values.data(), c_values.size());
+    
+    // Read constraint matrix rows (next numConstraints lines)
+    A = Eigen::MatrixXd(numConstraints, numVars);
+    for (int i = 0; i < numConstraints; i++) {
+        if (!std::getline(file, line)) {
+            throw std::runtime_error("Not enough rows for constraint matrix.");
+        }
+        std::istringstream iss_row(line);
+        for (int j = 0; j < numVars; j++) {
+            if (!(iss_row >> val)) {
+                throw std::runtime_error("Error reading matrix entry.");
+            }
+            A(i, j) = val;
+        }
+    }
+    
+    // Read right-hand side vector (last line)
+    std::getline(file, line);
+    std::istringstream iss_rhs(line);
+    std::vector<double> b_values;
+    while (iss_rhs >> val) {
+        b_values.push_back(val);
+    }
+    if (b_values.size() != static_cast<size_t>(numConstraints)) {
+        throw std::runtime_error("RHS vector size mismatch.");
+    }
+    b = Eigen::VectorXd::Map(b_values.data(), b_values.size());
+    
+    file.close();
+}
+
 bool containsNanOrInf(const Eigen::VectorXd& vec) {
     for (int i = 0; i < vec.size(); i++) {
         if (std::isnan(vec(i)) || std::isinf(vec(i))) {
@@ -0,0 +1,297 @@
+#include "out_of_core_lp.h"
+#include "predictor_corrector.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Limits for scaling factors, as in LPUtils::scaleLP
+static const double MAX_SCALING = 1e6;
+static const double MIN_SCALING = 1e-6;
+
+// Streamed products with the implicitly scaled A_s = diag(r) A diag(q); the
+// normal matrix, dense or the sparse part of the split form, is accumulated
+// in the residual pass
+struct OutOfCoreLP::Backend {
+    typedef Eigen::VectorXd VectorM;
+    typedef Eigen::VectorXd VectorN;
+
+    Backend(const ColumnBlockMatrix& A_, const LPUtils::ScalingInfo& scaling_,
+            const Eigen::VectorXd& b_, const Eigen::VectorXd& c_, const InteriorPointLP::Parameters& params_)
+        : A(A_), scaling(scaling_), rhs(b_), cost(c_), params(params_) {}
+
+    const VectorM& b() const { return rhs; }
+    const VectorN& c() const { return cost; }
+
+    void multiply(const VectorN& v, VectorM& out) {
+        out = scaling.row_scaling.cwiseProduct(A.multiply(scaling.col_scaling.cwiseProduct(v)));
+    }
+
+    void multiplyTranspose(const VectorM& y, VectorN& out) {
+        out = scaling.col_scaling.cwiseProduct(A.multiplyTranspose(scaling.row_scaling.cwiseProduct(y)));
+    }
+
+    void residuals(const VectorN& x, const VectorM& lambda, const VectorN& s, const VectorN* d,
+                   VectorM& rb, VectorN& rc)
+    {
+        residualsAndNormal(A, scaling, rhs, cost, x, lambda, s, d, rb, rc, ne, normal);
+    }
+
+    // The normal matrix was accumulated for d by residuals()
+    bool factor(const VectorN&) {
+        if (ne.use_sparse) {
+            return InteriorPointLP::factorFormedSplitNormalEquations(ne, params);
+        }
+        return InteriorPointLP::factorDenseNormalEquations(normal, params, ne);
+    }
+
+    bool solve(const VectorM& r, VectorM& y) { return InteriorPointLP::solveNormalEquations(ne, r, y); }
+
+    double unscaledNorm(const VectorM& r) const { return r.cwiseQuotient(scaling.row_scaling).norm(); }
+
+    const ColumnBlockMatrix& A;
+    const LPUtils::ScalingInfo& scaling;
+    const Eigen::VectorXd& rhs;
+    const Eigen::VectorXd& cost;
+    const InteriorPointLP::Parameters& params;
+    InteriorPointLP::NormalEquations ne;
+    Eigen::MatrixXd normal;
+};
+
+InteriorPointLP::Result OutOfCoreLP::solve(const ColumnBlockMatrix& A, const Eigen::VectorXd& b_orig,
+                                           const Eigen::VectorXd& c_orig)
+{
+    typedef PredictorCorrector<Backend> Iteration;
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point setup_start = Clock::now();
+    const InteriorPointLP::Parameters& params = InteriorPointLP::params;
+
+    if (A.rows() != b_orig.size()) {
+        throw std::invalid_argument("Matrix A rows must match vector b size");
+    }
+    if (A.cols() != c_orig.size()) {
+        throw std::invalid_argument("Matrix A columns must match vector c size");
+    }
+
+    const int n = A.cols();
+    const int m = A.rows();
+    const double b_norm = b_orig.norm();
+    const double c_norm = c_orig.norm();
+
+    if (params.verbose) {
+        std::cout << "Solving LP problem with " << n << " variables and " << m << " constraints out of core ("
+                  << A.numBlocks() << " blocks of " << A.blockCols() << " columns)" << std::endl;
+    }
+
+    Eigen::VectorXd b = b_orig;
+    Eigen::VectorXd c = c_orig;
+    LPUtils::ScalingInfo scaling;
+    if (params.use_scaling) {
+        scaling = computeScaling(A, b, c);
+    } else {
+        scaling.row_scaling = Eigen::VectorXd::Ones(m);
+        scaling.col_scaling = Eigen::VectorXd::Ones(n);
+    }
+
+    Backend backend(A, scaling, b, c, params);
+    if (params.split_dense_columns) {
+        analyzeNormalEquations(A, scaling, params, backend.ne);
+    }
+
+    Eigen::VectorXd x, lambda, s;
+    Iteration::initialPoint(c, m, x, lambda, s);
+
+    InteriorPointLP::Result result;
+    Clock::time_point iteration_start = Clock::now();
+    result.setup_time = std::chrono::duration<double>(iteration_start - setup_start).count();
+
+    Eigen::VectorXd rb, rc;
+    Iteration::Outcome outcome = Iteration::run(backend, params, x, lambda, s, rb, rc, b_norm, c_norm,
+                                                params.time_budget - result.setup_time);
+    result.status = outcome.status;
+    result.success = outcome.status == InteriorPointLP::Status::Optimal;
+    result.iterations = outcome.iterations;
+
+    bool anytime_point = Iteration::useAnytimePoint(backend, outcome, x, lambda, s, rb, rc);
+    result.lower_bound = outcome.bounds.lower;
+    result.upper_bound = outcome.bounds.upper;
+    InteriorPointLP::fillResult(result, x, lambda, s, rc, rb, c, scaling, b_norm, c_norm);
+    result.iteration_time = std::chrono::duration<double>(Clock::now() - iteration_start).count();
+
+    if (params.verbose) {
+        InteriorPointLP::printSummary(result, outcome.status, anytime_point);
+    }
+    return result;
+}
+
+void OutOfCoreLP::analyzeNormalEquations(const ColumnBlockMatrix& A, const LPUtils::ScalingInfo& scaling,
+                                         const InteriorPointLP::Parameters& params,
+                                         InteriorPointLP::NormalEquations& ne)
+{
+    typedef ColumnBlockMatrix::Block Block;
+
+    const int m = A.rows();
+    const int n = A.cols();
+    if (m == 0) {
+        return;
+    }
+
+    // Same column classification as the in-memory path, from one counting pass
+    std::vector<int> col_nnz(n);
+    A.forEachBlock([&](Eigen::Index j0, const Block& A_k) {
+        for (Eigen::Index k = 0; k < A_k.cols(); k++) {
+            col_nnz[j0 + k] = (A_k.col(k).array() != 0.0).count();
+        }
+    });
+    if (!InteriorPointLP::splitColumns(col_nnz, m, params, ne)) {
+        return;
+    }
+
+    // Gather the scaled dense columns (fewer than m, so at most m^2 values)
+    // in a second pass. The sparse columns stay on disk: the residual pass
+    // accumulates their part of the normal matrix block by block.
+    const int n_dense = ne.dense_cols.size();
+    const Eigen::VectorXd& r = scaling.row_scaling;
+    const Eigen::VectorXd& q = scaling.col_scaling;
+    ne.A_dense.resize(m, n_dense);
+    std::size_t next = 0;
+    A.forEachBlock([&](Eigen::Index j0, const Block& A_k) {
+        for (; next < ne.dense_cols.size() && ne.dense_cols[next] < j0 + A_k.cols(); next++) {
+            const int j = ne.dense_cols[next];
+            ne.A_dense.col(next) = q(j) * r.cwiseProduct(A_k.col(j - j0));
+        }
+    });
+    ne.use_sparse = true;
+
+    if (params.verbose) {
+        std::cout << "Using sparse normal equations with " << n_dense << " dense columns split off" << std::endl;
+    }
+}
+
+LPUtils::ScalingInfo OutOfCoreLP::computeScaling(const ColumnBlockMatrix& A, Eigen::VectorXd& b, Eigen::VectorXd& c) {
+    typedef ColumnBlockMatrix::Block Block;
+
+    LPUtils::ScalingInfo scaling;
+    const int m = A.rows();
+    const int n = A.cols();
+    scaling.row_scaling = Eigen::VectorXd::Ones(m);
+    scaling.col_scaling = Eigen::VectorXd::Ones(n);
+
+    // Skip scaling for small problems
+    if (n < 50 && m < 50) {
+        return scaling;
+    }
+    scaling.is_scaled = true;
+
+    Eigen::VectorXd& r = scaling.row_scaling;
+    Eigen::VectorXd& q = scaling.col_scaling;
+    Eigen::VectorXd row_max(m);
+    Eigen::VectorXd col_max(n);
+
+    for (int iter = 0; iter < 5; iter++) {
+        // Row maxima of A diag(q); times r(i) they are those of the scaled matrix
+        row_max.setZero();
+        A.forEachBlock([&](Eigen::Index j0, const Block& A_k) {
+            row_max = row_max.cwiseMax((A_k.cwiseAbs() * q.segment(j0, A_k.cols()).asDiagonal()).rowwise().maxCoeff());
+        });
+        for (int i = 0; i < m; i++) {
+            if (row_max(i) * r(i) > 0) {
+                double scale = std::min(std::max(1.0 / (row_max(i) * r(i)), MIN_SCALING), MAX_SCALING);
+                b(i) *= scale;
+                r(i) *= scale;
+            }
+        }
+
+        // Column maxima with the updated row scaling
+        A.forEachBlock([&](Eigen::Index j0, const Block& A_k) {
+            col_max.segment(j0, A_k.cols()) = (r.asDiagonal() * A_k.cwiseAbs()).colwise().maxCoeff().transpose();
+        });
+        for (int j = 0; j < n; j++) {
+            if (col_max(j) * q(j) > 0) {
+                double scale = std::min(std::max(1.0 / (col_max(j) * q(j)), MIN_SCALING), MAX_SCALING);
+                c(j) *= scale;
+                q(j) *= scale;
+            }
+        }
+    }
+
+    return scaling;
+}
+
+void OutOfCoreLP::residualsAndNormal(
+    const ColumnBlockMatrix& A, const LPUtils::ScalingInfo& scaling,
+    const Eigen::VectorXd& b, const Eigen::VectorXd& c,
+    const Eigen::VectorXd& x, const Eigen::VectorXd& lambda, const Eigen::VectorXd& s,
+    const Eigen::VectorXd* d, Eigen::VectorXd& rb, Eigen::VectorXd& rc,
+    InteriorPointLP::NormalEquations& ne, Eigen::MatrixXd& normal)
+{
+    typedef ColumnBlockMatrix::Block Block;
+    typedef Eigen::SparseMatrix<double> SpMat;
+
+    // A_s = diag(r) A diag(q), so A_s x = r .* A (q .* x), A_s^T lambda = q .* A^T (r .* lambda)
+    // and A_s D A_s^T = diag(r) A diag(q^2 .* d) A^T diag(r)
+    const Eigen::VectorXd& r = scaling.row_scaling;
+    const Eigen::VectorXd& q = scaling.col_scaling;
+    const Eigen::VectorXd qx = q.cwiseProduct(x);
+    const Eigen::VectorXd r_lambda = r.cwiseProduct(lambda);
+    const Eigen::Index m = A.rows();
+    const bool dense_normal = d && !ne.use_sparse;
+    const bool split_normal = d && ne.use_sparse;
+    Eigen::VectorXd w;
+    if (d) {
+        w = (q.array().square() * d->array()).sqrt().matrix();
+    }
+    if (dense_normal) {
+        normal.setZero(m, m);
+    }
+    if (split_normal) {
+        ne.M_sparse.resize(m, m);
+        ne.M_sparse.setZero();
+    }
+
+    Eigen::VectorXd Ax = Eigen::VectorXd::Zero(m);
+    Eigen::MatrixXd AW;
+    SpMat S;
+    std::vector<Eigen::Triplet<double>> triplets;
+    std::size_t next_dense = 0;
+    A.forEachBlock([&](Eigen::Index j0, const Block& A_k) {
+        const Eigen::Index k = A_k.cols();
+        Ax.noalias() += A_k * qx.segment(j0, k);
+        rc.segment(j0, k).noalias() = A_k.transpose() * r_lambda;
+        if (dense_normal) {
+            AW.noalias() = A_k * w.segment(j0, k).asDiagonal();
+            normal.selfadjointView<Eigen::Lower>().rankUpdate(AW);
+        }
+        if (split_normal) {
+            // Weighted sparse columns of the block, S_k W_k, add S_k W_k^2 S_k^T
+            triplets.clear();
+            for (Eigen::Index l = 0; l < k; l++) {
+                if (next_dense < ne.dense_cols.size() && ne.dense_cols[next_dense] == j0 + l) {
+                    next_dense++;
+                    continue;
+                }
+                for (Eigen::Index i = 0; i < m; i++) {
+                    if (A_k(i, l) != 0.0) {
+                        triplets.emplace_back(i, l, A_k(i, l) * w(j0 + l));
+                    }
+                }
+            }
+            S.resize(m, k);
+            S.setFromTriplets(triplets.begin(), triplets.end());
+            ne.M_sparse += SpMat(S * S.transpose());
+        }
+    });
+
+    rb = r.cwiseProduct(Ax) - b;
+    rc = q.cwiseProduct(rc) + s - c;
+    if (dense_normal) {
+        normal = normal.selfadjointView<Eigen::Lower>();
+        normal = r.asDiagonal() * normal * r.asDiagonal();
+    }
+    if (split_normal) {
+        ne.M_sparse = r.asDiagonal() * ne.M_sparse * r.asDiagonal();
+        ne.d_dense.resize(ne.dense_cols.size());
+        for (std::size_t l = 0; l < ne.dense_cols.size(); l++) {
+            ne.d_dense(l) = (*d)(ne.dense_cols[l]);
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#include "tiny_lp.h"
+
+namespace {
+
+// Kernel behind the runtime dispatch: dynamic sizes with fixed upper bounds,
+// so storage is still on the stack but one instantiation covers every size
+typedef TinyLP<Eigen::Dynamic, Eigen::Dynamic, TINY_LP_MAX_ROWS, TINY_LP_MAX_COLS> BoundedTinyLP;
+
+// Run the kernel for one instantiation and copy its solution into result
+template <typename Kernel>
+void runTinyLP(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, const Eigen::VectorXd& c,
+               const InteriorPointLP::Parameters& params, InteriorPointLP::Result& result)
+{
+    typename Kernel::Solution sol;
+    Kernel::solve(A, b, c, params, sol);
+
+    result.success = sol.success;
+    result.status = sol.status;
+    result.x = sol.x;
+    result.lambda = sol.lambda;
+    result.s = sol.s;
+    result.optimal_value = sol.optimal_value;
+    result.primal_infeas = sol.primal_infeas;
+    result.dual_infeas = sol.dual_infeas;
+    result.gap = sol.gap;
+    result.iterations = sol.iterations;
+    result.lower_bound = sol.lower_bound;
+    result.upper_bound = sol.upper_bound;
+}
+
+} // namespace
+
+bool solveTinyLP(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, const Eigen::VectorXd& c,
+                 const InteriorPointLP::Parameters& params, InteriorPointLP::Result& result)
+{
+    if (A.rows() < 1 || A.rows() > TINY_LP_MAX_ROWS || A.cols() > TINY_LP_MAX_COLS || A.cols() < A.rows()) {
+        return false;
+    }
+
+#define TINY_LP_DISPATCH(M, N)                                              \
+    if (A.rows() == M && A.cols() == N) {                                   \
+        runTinyLP<TinyLP<M, N>>(A, b, c, params, result);                   \
+        return true;                                                        \
+    }
+    TINY_LP_FIXED_SIZES(TINY_LP_DISPATCH)
+#undef TINY_LP_DISPATCH
+
+    runTinyLP<BoundedTinyLP>(A, b, c, params, result);
+    return true;
+}
@@ -0,0 +1,63 @@
+// Anytime mode: the bounds must bracket the optimum and the returned
+// objective, the upper bound point must be feasible to 1e-2 tol, and the
+// gap target and time budget must stop the solve with their status
+#include "interior_point_lp.h"
+#include "lp_utils.h"
+#include "test_common.h"
+#include <cmath>
+#include <string>
+
+void checkBounds(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, const Eigen::VectorXd& c) {
+    InteriorPointLP::Parameters p;
+    p.tol = 1e-8;
+    p.max_iter = 500;
+    InteriorPointLP::setParameters(p);
+    const double optimum = InteriorPointLP::solve(A, b, c).optimal_value;
+
+    // Stopped by the gap target
+    p.tol = 1e-6;
+    p.gap_target = 1e-3;
+    InteriorPointLP::setParameters(p);
+    InteriorPointLP::Result result = InteriorPointLP::solve(A, b, c);
+    const double slack = 1e-6 * (1.0 + std::abs(optimum));
+    CHECK(result.status == InteriorPointLP::Status::GapReached && !result.success);
+    CHECK(result.lower_bound <= optimum + slack && optimum <= result.upper_bound + slack);
+    CHECK(result.lower_bound <= result.optimal_value && result.optimal_value <= result.upper_bound);
+    CHECK(result.upper_bound - result.lower_bound <= 1e-3 * std::max(1.0, std::abs(result.upper_bound)));
+    CHECK((A * result.x - b).norm() <= 1e-2 * p.tol * (1.0 + b.norm()) * 1.01);
+    CHECK(result.x.minCoeff() >= 0.0);
+
+    // Stopped by the time budget right away: whatever bounds exist are ordered
+    p.gap_target = 0.0;
+    p.time_budget = 1e-9;
+    InteriorPointLP::setParameters(p);
+    result = InteriorPointLP::solve(A, b, c);
+    CHECK(result.status == InteriorPointLP::Status::TimeLimit && !result.success);
+    CHECK(result.lower_bound <= result.upper_bound);
+    CHECK(result.lower_bound <= optimum + slack);
+
+    // Run to convergence in anytime mode: the point of the upper bound is returned
+    p.time_budget = 60.0;
+    InteriorPointLP::setParameters(p);
+    result = InteriorPointLP::solve(A, b, c);
+    CHECK(result.status == InteriorPointLP::Status::Optimal && result.success);
+    CHECK(result.lower_bound <= result.optimal_value && result.optimal_value <= result.upper_bound);
+}
+
+int main(int argc, char** argv) {
+    Eigen::MatrixXd A;
+    Eigen::VectorXd b, c;
+    int n = 0, m = 0;
+
+    // The 50 x 100 and the 5 x 10 (fixed-size kernel) problems of the data folder
+    for (int i = 1; i < argc; i++) {
+        LPUtils::readLPData(argv[i], A, b, c, n, m);
+        checkBounds(A, b, c);
+    }
+
+    // Sparse with dense columns (split factorization)
+    randomLP(150, 400, 0.02, 4, 5, A, b, c);
+    checkBounds(A, b, c);
+
+    return test_failures;
+}
@@ -0,0 +1,64 @@
+// IncrementalLP after appended rows and columns must reach the optimum of a
+// cold solve of the same problem, and its warm starts must not cost more
+// iterations in total than the cold solves
+#include "incremental_lp.h"
+#include "interior_point_lp.h"
+#include "lp_utils.h"
+#include "test_common.h"
+#include <cmath>
+#include <string>
+
+int main(int argc, char** argv) {
+    // The 50 x 100 feasible LP of the data folder
+    std::string filename = argc > 1 ? argv[1] : "data/feasible_lp.txt";
+    Eigen::MatrixXd A;
+    Eigen::VectorXd b, c;
+    int n = 0, m = 0;
+    LPUtils::readLPData(filename, A, b, c, n, m);
+    const int initial_rows = m - 10, new_cols = 10;
+
+    for (int scaling = 0; scaling < 2; scaling++) {
+        InteriorPointLP::Parameters p;
+        p.tol = 1e-6;
+        p.max_iter = 500;
+        p.use_scaling = scaling;
+        InteriorPointLP::setParameters(p);
+
+        IncrementalLP incremental(A.topRows(initial_rows), b.head(initial_rows), c);
+        CHECK(incremental.solve().success);
+
+        int warm_iterations = 0, cold_iterations = 0;
+        for (int i = initial_rows; i < m; i += 2) {
+            incremental.addRows(A.middleRows(i, 2), b.segment(i, 2));
+
+            InteriorPointLP::Result warm = incremental.solve();
+            InteriorPointLP::Result cold = InteriorPointLP::solve(A.topRows(i + 2), b.head(i + 2), c);
+            CHECK(warm.success && cold.success);
+            CHECK(std::abs(warm.optimal_value - cold.optimal_value) <= 1e-5 * (1.0 + std::abs(cold.optimal_value)));
+            warm_iterations += warm.iterations;
+            cold_iterations += cold.iterations;
+        }
+        CHECK(warm_iterations <= cold_iterations);
+
+        // New columns on the scale of the data, with positive costs so that
+        // the problem stays feasible and bounded
+        std::mt19937 rng(17);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        Eigen::MatrixXd A_cols = Eigen::MatrixXd::NullaryExpr(m, new_cols, [&]() { return 10.0 * uniform(rng); });
+        Eigen::VectorXd c_cols = Eigen::VectorXd::NullaryExpr(new_cols, [&]() { return 10.0 * uniform(rng) + 1.0; });
+        incremental.addColumns(A_cols, c_cols);
+        CHECK(incremental.rows() == m && incremental.cols() == n + new_cols);
+
+        Eigen::MatrixXd A_full(m, n + new_cols);
+        A_full << A, A_cols;
+        Eigen::VectorXd c_full(n + new_cols);
+        c_full << c, c_cols;
+        InteriorPointLP::Result warm = incremental.solve();
+        InteriorPointLP::Result cold = InteriorPointLP::solve(A_full, b, c_full);
+        CHECK(warm.success && cold.success);
+        CHECK(std::abs(warm.optimal_value - cold.optimal_value) <= 1e-5 * (1.0 + std::abs(cold.optimal_value)));
+        CHECK(warm.x.size() == n + new_cols);
+    }
+
+    return test_failures;
+}
@@ -0,0 +1,77 @@
+// LPSolveCache: exact repeats are hits (from memory, and from the disk store
+// after the memory is cleared), a new c on the same A and b is warm started
+// to the cold optimum, and results that did not converge are not stored
+#include "interior_point_lp.h"
+#include "lp_solve_cache.h"
+#include "lp_utils.h"
+#include "test_common.h"
+#include <cmath>
+#include <filesystem>
+#include <string>
+
+int main(int argc, char** argv) {
+    std::string filename = argc > 1 ? argv[1] : "data/feasible_lp.txt";
+    Eigen::MatrixXd A;
+    Eigen::VectorXd b, c;
+    int n = 0, m = 0;
+    LPUtils::readLPData(filename, A, b, c, n, m);
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "lp_solve_cache_test";
+    std::filesystem::remove_all(directory);
+
+    InteriorPointLP::Parameters p;
+    p.tol = 1e-6;
+    p.max_iter = 500;
+    InteriorPointLP::setParameters(p);
+
+    {
+        LPSolveCache cache(std::size_t(16) << 20, directory.string());
+        LPSolveCache::Source source;
+
+        InteriorPointLP::Result first = cache.solve(A, b, c, &source);
+        CHECK(source == LPSolveCache::Source::Solved && first.success);
+
+        InteriorPointLP::Result hit = cache.solve(A, b, c, &source);
+        CHECK(source == LPSolveCache::Source::Cached);
+        CHECK(hit.optimal_value == first.optimal_value && hit.x == first.x && hit.iterations == first.iterations);
+
+        // Same A and b, perturbed costs: warm start to the cold optimum
+        std::mt19937 rng(4);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        Eigen::VectorXd c2 = c + Eigen::VectorXd::NullaryExpr(n, [&]() { return uniform(rng); });
+        InteriorPointLP::Result warm = cache.solve(A, b, c2, &source);
+        InteriorPointLP::Result cold = InteriorPointLP::solve(A, b, c2);
+        CHECK(source == LPSolveCache::Source::WarmStarted);
+        CHECK(warm.success && cold.success);
+        CHECK(std::abs(warm.optimal_value - cold.optimal_value) <= 1e-5 * (1.0 + std::abs(cold.optimal_value)));
+
+        // From the disk store once memory is cleared
+        cache.clear();
+        hit = cache.solve(A, b, c, &source);
+        CHECK(source == LPSolveCache::Source::Cached);
+        CHECK(cache.stats().disk_hits == 1);
+        CHECK(hit.optimal_value == first.optimal_value && hit.x == first.x);
+
+        // Other parameters are another problem, and an iteration-limited
+        // result is not answered from the cache
+        p.max_iter = 3;
+        InteriorPointLP::setParameters(p);
+        InteriorPointLP::Result limited = cache.solve(A, b, c, &source);
+        CHECK(source != LPSolveCache::Source::Cached && !limited.success);
+        limited = cache.solve(A, b, c, &source);
+        CHECK(source != LPSolveCache::Source::Cached && !limited.success);
+    }
+
+    // A new cache on the same directory answers the converged problem from disk
+    p.max_iter = 500;
+    InteriorPointLP::setParameters(p);
+    {
+        LPSolveCache cache(std::size_t(16) << 20, directory.string());
+        LPSolveCache::Source source;
+        cache.solve(A, b, c, &source);
+        CHECK(source == LPSolveCache::Source::Cached);
+    }
+
+    std::filesystem::remove_all(directory);
+    return test_failures;
+}
@@ -0,0 +1,42 @@
+// The split factorization of the normal equations (sparse LDL^T plus a
+// Sherman-Morrison-Woodbury correction for the dense columns) must reach
+// the same optimum as the dense factorization
+#include "interior_point_lp.h"
+#include "test_common.h"
+#include <cmath>
+
+InteriorPointLP::Result solveWith(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, const Eigen::VectorXd& c,
+                                  bool split, bool scaling) {
+    InteriorPointLP::Parameters p;
+    p.tol = 1e-6;
+    p.max_iter = 500;
+    p.use_scaling = scaling;
+    p.split_dense_columns = split;
+    InteriorPointLP::setParameters(p);
+    return InteriorPointLP::solve(A, b, c);
+}
+
+int main() {
+    Eigen::MatrixXd A;
+    Eigen::VectorXd b, c;
+
+    // Sparse with a few dense columns, so the split form is used
+    randomLP(150, 400, 0.02, 4, 5, A, b, c);
+    for (int scaling = 0; scaling < 2; scaling++) {
+        InteriorPointLP::Result split = solveWith(A, b, c, true, scaling);
+        InteriorPointLP::Result dense = solveWith(A, b, c, false, scaling);
+        CHECK(split.success && dense.success);
+        CHECK(std::abs(split.optimal_value - dense.optimal_value) <= 1e-5 * (1.0 + std::abs(dense.optimal_value)));
+        CHECK((A * split.x - b).norm() <= 1e-5 * (1.0 + b.norm()));
+        CHECK(split.x.minCoeff() >= 0.0);
+    }
+
+    // All columns dense: both settings take the dense path
+    randomLP(80, 300, 1.0, 0, 9, A, b, c);
+    InteriorPointLP::Result split = solveWith(A, b, c, true, false);
+    InteriorPointLP::Result dense = solveWith(A, b, c, false, false);
+    CHECK(split.success && dense.success);
+    CHECK(std::abs(split.optimal_value - dense.optimal_value) <= 1e-5 * (1.0 + std::abs(dense.optimal_value)));
+
+    return test_failures;
+}
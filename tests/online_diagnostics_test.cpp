@@ -0,0 +1,70 @@
+// PSRF and ESS of OnlineChainStats / MultiChainMonitor on chains with a
+// known answer: independent draws, chains stuck in different places, and
+// an AR(1) chain with a known autocorrelation time
+#include "online_diagnostics.h"
+#include "test_common.h"
+#include <random>
+
+int main() {
+    const int dim = 2, num_chains = 4, points = 20000;
+    std::mt19937 rng(11);
+    std::normal_distribution<double> normal;
+    Eigen::VectorXd x(dim);
+
+    // Independent draws from one distribution: PSRF close to 1, ESS close
+    // to the number of points
+    MultiChainMonitor<double> iid(num_chains, dim);
+    for (int k = 0; k < num_chains; k++) {
+        OnlineChainStats<double> stats(dim);
+        for (int j = 0; j < points; j++) {
+            x << normal(rng), normal(rng);
+            stats.update(x);
+        }
+        iid.publish(k, stats);
+    }
+    CHECK(iid.minCount() == points);
+    CHECK(iid.psrf().maxCoeff() < 1.01);
+    CHECK(iid.ess().minCoeff() > 0.5 * num_chains * points);
+    ConvergenceTarget target;
+    target.max_psrf = 1.1;
+    target.min_ess = 1000;
+    CHECK(iid.converged(target));
+
+    // Chains stuck around different means: PSRF well above 1
+    MultiChainMonitor<double> stuck(num_chains, dim);
+    for (int k = 0; k < num_chains; k++) {
+        OnlineChainStats<double> stats(dim);
+        for (int j = 0; j < points; j++) {
+            x << k + 0.1 * normal(rng), normal(rng);
+            stats.update(x);
+        }
+        stuck.publish(k, stats);
+    }
+    Eigen::VectorXd psrf = stuck.psrf();
+    CHECK(psrf(0) > 2.0);
+    CHECK(psrf(1) < 1.01);
+    CHECK(!stuck.converged(target));
+
+    // A chain that has not published yet holds the count at zero
+    MultiChainMonitor<double> partial(num_chains, dim);
+    OnlineChainStats<double> one(dim);
+    x.setZero();
+    one.update(x);
+    partial.publish(0, one);
+    CHECK(partial.minCount() == 0);
+
+    // AR(1) with rho = 0.9: ESS / n = (1 - rho) / (1 + rho) = 0.0526 and
+    // stationary variance 1 / (1 - rho^2) = 5.26
+    OnlineChainStats<double> ar(1);
+    Eigen::VectorXd y = Eigen::VectorXd::Zero(1);
+    const int ar_points = 1000000;
+    for (int j = 0; j < ar_points; j++) {
+        y(0) = 0.9 * y(0) + normal(rng);
+        ar.update(y);
+    }
+    const double ess_ratio = ar.ess()(0) / ar_points;
+    CHECK(ess_ratio > 0.035 && ess_ratio < 0.075);
+    CHECK(std::abs(ar.variance()(0) - 1.0 / 0.19) < 0.3);
+
+    return test_failures;
+}
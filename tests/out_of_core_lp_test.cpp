@@ -0,0 +1,49 @@
+// OutOfCoreLP on a column block file must follow the in-memory solver, on
+// the dense path and on the split path with the streamed sparse part
+#include "column_block_matrix.h"
+#include "interior_point_lp.h"
+#include "out_of_core_lp.h"
+#include "test_common.h"
+#include <cmath>
+#include <filesystem>
+#include <string>
+
+int main() {
+    const std::string filename = (std::filesystem::temp_directory_path() / "out_of_core_lp_test.lpcb").string();
+    Eigen::MatrixXd A;
+    Eigen::VectorXd b, c;
+
+    // Sparse with four dense columns; 37 columns per block leaves a partial last block
+    randomLP(150, 400, 0.02, 4, 5, A, b, c);
+    ColumnBlockMatrix::write(filename, A, 37);
+    {
+        ColumnBlockMatrix A_file(filename);
+        CHECK(A_file.rows() == A.rows() && A_file.cols() == A.cols());
+        Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(A.cols(), -1.0, 1.0);
+        Eigen::VectorXd y = Eigen::VectorXd::LinSpaced(A.rows(), 2.0, -1.0);
+        CHECK((A_file.multiply(x) - A * x).norm() <= 1e-12 * (A * x).norm());
+        CHECK((A_file.multiplyTranspose(y) - A.transpose() * y).norm() <= 1e-12 * (A.transpose() * y).norm());
+
+        for (int split = 0; split < 2; split++) {
+            for (int scaling = 0; scaling < 2; scaling++) {
+                InteriorPointLP::Parameters p;
+                p.tol = 1e-6;
+                p.max_iter = 500;
+                p.split_dense_columns = split;
+                p.use_scaling = scaling;
+                InteriorPointLP::setParameters(p);
+
+                InteriorPointLP::Result in_core = InteriorPointLP::solve(A, b, c);
+                InteriorPointLP::Result out_of_core = OutOfCoreLP::solve(A_file, b, c);
+                CHECK(in_core.success && out_of_core.success);
+                CHECK(std::abs(out_of_core.optimal_value - in_core.optimal_value)
+                      <= 1e-6 * (1.0 + std::abs(in_core.optimal_value)));
+                CHECK(std::abs(out_of_core.iterations - in_core.iterations) <= 1);
+                CHECK((A * out_of_core.x - b).norm() <= 1e-5 * (1.0 + b.norm()));
+            }
+        }
+    }
+
+    std::filesystem::remove(filename);
+    return test_failures;
+}
@@ -0,0 +1,110 @@
+// Round trip of the sample sinks: points written through BlockedSinkWriter
+// and TeeSampleSink are read back from the CSV and binary files unchanged
+#include "sample_sink.h"
+#include "test_common.h"
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef Eigen::MatrixXd MT;
+
+// Point type as seen by BlockedSinkWriter
+struct TestPoint {
+    Eigen::VectorXd coefficients;
+    const Eigen::VectorXd& getCoefficients() const { return coefficients; }
+};
+
+// Points of each chain in file order, from "chain,x_0,...,x_{d-1}" lines
+std::vector<std::vector<Eigen::VectorXd>> readCsv(const std::string& filename, int dim, int num_chains) {
+    std::vector<std::vector<Eigen::VectorXd>> chains(num_chains);
+    std::ifstream in(filename);
+    std::string line;
+    std::getline(in, line); // Header
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string field;
+        std::getline(fields, field, ',');
+        Eigen::VectorXd point(dim);
+        for (int i = 0; i < dim; i++) {
+            std::getline(fields, field, ',');
+            point(i) = std::strtod(field.c_str(), nullptr);
+        }
+        chains.at(std::stoi(line)).push_back(point);
+    }
+    return chains;
+}
+
+// Points of each chain in file order, from the BinarySampleSink layout
+std::vector<std::vector<Eigen::VectorXd>> readBinary(const std::string& filename, int dim, int num_chains) {
+    std::vector<std::vector<Eigen::VectorXd>> chains(num_chains);
+    std::ifstream in(filename, std::ios::binary);
+    char magic[4];
+    std::uint32_t header[3];
+    in.read(magic, 4);
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    CHECK(std::string(magic, 4) == "SMPL");
+    CHECK(header[0] == 1u && header[1] == std::uint32_t(dim) && header[2] == sizeof(double));
+
+    std::uint32_t record[2];
+    while (in.read(reinterpret_cast<char*>(record), sizeof(record))) {
+        for (std::uint32_t j = 0; j < record[1]; j++) {
+            Eigen::VectorXd point(dim);
+            in.read(reinterpret_cast<char*>(point.data()), sizeof(double) * dim);
+            chains.at(record[0]).push_back(point);
+        }
+    }
+    return chains;
+}
+
+int main() {
+    const int dim = 3, num_chains = 2, points = 11;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string csv_filename = (dir / "sample_sink_test.csv").string();
+    const std::string binary_filename = (dir / "sample_sink_test.bin").string();
+
+    // Values that need all 17 digits, and some exact ones
+    std::srand(7);
+    std::vector<MT> expected(num_chains, MT::Random(dim, points));
+    expected[1] = MT::Random(dim, points) * 1e-7;
+    expected[1](0, 0) = 0.0;
+    expected[1](1, 0) = -2.5;
+
+    {
+        CsvSampleSink<MT> csv_sink(csv_filename, dim);
+        BinarySampleSink<MT> binary_sink(binary_filename, dim);
+        TeeSampleSink<MT> sink(csv_sink, binary_sink);
+
+        // Chain 0 through a writer with a partial last block, chain 1 as a
+        // block of columns of a larger matrix
+        BlockedSinkWriter<MT, TestPoint> writer(sink, 0, dim, 4);
+        for (int j = 0; j < points; j++) {
+            writer.push_back(TestPoint{expected[0].col(j)});
+        }
+        writer.finish();
+        CHECK(writer.size() == points);
+
+        MT padded = MT::Zero(dim, points + 2);
+        padded.middleCols(1, points) = expected[1];
+        sink.write_block(1, padded.middleCols(1, points), points);
+        sink.flush();
+    }
+
+    std::vector<std::vector<Eigen::VectorXd>> csv = readCsv(csv_filename, dim, num_chains);
+    std::vector<std::vector<Eigen::VectorXd>> binary = readBinary(binary_filename, dim, num_chains);
+    for (int k = 0; k < num_chains; k++) {
+        CHECK(int(csv[k].size()) == points);
+        CHECK(int(binary[k].size()) == points);
+        for (int j = 0; j < points && j < int(csv[k].size()) && j < int(binary[k].size()); j++) {
+            CHECK(csv[k][j] == expected[k].col(j));
+            CHECK(binary[k][j] == expected[k].col(j));
+        }
+    }
+
+    std::filesystem::remove(csv_filename);
+    std::filesystem::remove(binary_filename);
+    return test_failures;
+}
@@ -0,0 +1,41 @@
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+#include <Eigen/Dense>
+#include <iostream>
+#include <random>
+
+// Minimal checks for the test executables: a failed CHECK is reported with
+// its location and counted, and main returns the count (nonzero fails ctest)
+static int test_failures = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition   \
+                      << std::endl;                                                       \
+            test_failures++;                                                              \
+        }                                                                                 \
+    } while (0)
+
+// Random LP min c^T x s.t. Ax = b, x >= 0 that is feasible (b = A x0 with
+// x0 > 0), bounded (c > 0) and has full row rank (an identity block after
+// the dense columns). A has density nonzeros in its other columns and
+// dense_cols fully dense leading columns.
+inline void randomLP(int m, int n, double density, int dense_cols, unsigned int seed,
+                     Eigen::MatrixXd& A, Eigen::VectorXd& b, Eigen::VectorXd& c) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    A = Eigen::MatrixXd::NullaryExpr(m, n, [&]() { return uniform(rng) < density ? 5.0 * uniform(rng) : 0.0; });
+    for (int j = 0; j < dense_cols; j++) {
+        A.col(j) = Eigen::VectorXd::NullaryExpr(m, [&]() { return uniform(rng); });
+    }
+    for (int i = 0; i < m; i++) {
+        A(i, dense_cols + i) = 1.0;
+    }
+    Eigen::VectorXd x0 = Eigen::VectorXd::NullaryExpr(n, [&]() { return uniform(rng); });
+    b = A * x0;
+    c = Eigen::VectorXd::NullaryExpr(n, [&]() { return uniform(rng) + 0.1; });
+}
+
+#endif // TEST_COMMON_H
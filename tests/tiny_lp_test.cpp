@@ -0,0 +1,49 @@
+// The fixed-size kernels (exact and bounded sizes) must agree with the
+// dynamic solver, and sizes above the bounds must be left to it
+#include "interior_point_lp.h"
+#include "lp_utils.h"
+#include "test_common.h"
+#include "tiny_lp.h"
+#include <cmath>
+#include <string>
+
+// Solve with the kernel and with the dynamic solver and compare
+void compare(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, const Eigen::VectorXd& c) {
+    InteriorPointLP::Parameters p;
+    p.tol = 1e-6;
+    p.max_iter = 500;
+    p.use_tiny_kernels = false;
+    InteriorPointLP::setParameters(p);
+
+    InteriorPointLP::Result tiny;
+    CHECK(solveTinyLP(A, b, c, p, tiny));
+    InteriorPointLP::Result dynamic = InteriorPointLP::solve(A, b, c);
+    CHECK(tiny.success && dynamic.success);
+    CHECK(std::abs(tiny.optimal_value - dynamic.optimal_value) <= 1e-6 * (1.0 + std::abs(dynamic.optimal_value)));
+    CHECK(tiny.x.size() == A.cols() && tiny.lambda.size() == A.rows());
+    CHECK((A * tiny.x - b).norm() <= 1e-5 * (1.0 + b.norm()));
+}
+
+int main(int argc, char** argv) {
+    Eigen::MatrixXd A;
+    Eigen::VectorXd b, c;
+
+    // 5 x 10, which has an exact kernel
+    std::string filename = argc > 1 ? argv[1] : "data/feasible_lp105.txt";
+    int n = 0, m = 0;
+    LPUtils::readLPData(filename, A, b, c, n, m);
+    compare(A, b, c);
+
+    // Sizes served by the bounded kernel
+    randomLP(3, 6, 1.0, 0, 21, A, b, c);
+    compare(A, b, c);
+    randomLP(TINY_LP_MAX_ROWS, TINY_LP_MAX_COLS, 1.0, 0, 22, A, b, c);
+    compare(A, b, c);
+
+    // Too large for the kernels
+    randomLP(TINY_LP_MAX_ROWS + 1, TINY_LP_MAX_COLS + 2, 1.0, 0, 23, A, b, c);
+    InteriorPointLP::Result result;
+    CHECK(!solveTinyLP(A, b, c, InteriorPointLP::getParameters(), result));
+
+    return test_failures;
+}